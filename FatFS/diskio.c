@@ -7,6 +7,7 @@
 /* storage control modules to the FatFs module with a defined API.       */
 /*-----------------------------------------------------------------------*/
 
+#include <string.h>
 #include "ff.h"			/* Obtains integer types */
 #include "diskio.h"		/* Declarations of disk functions */
 #include "W25Qxx.h"
@@ -83,6 +84,11 @@ DRESULT disk_read (
 	case DEV_W25Q16:
 		{
 		uint32_t addr = sector << 12;	/* sector size is 4096 bytes */
+		const uint8_t *mem = W25Qxx_MapAddress(addr);
+		if (mem) {						/* The flash is memory mapped (QSPI), just copy the data */
+			memcpy(buff, mem, (uint32_t)count << 12);
+			return RES_OK;
+		}
 		uint16_t size = count  << 12;
 		W25Qxx_RET r = W25Qxx_Read(addr, buff, size);
 		switch (r) {
@@ -191,7 +197,8 @@ DRESULT disk_ioctl (
 		case GET_SECTOR_COUNT:
 			{
 			LBA_t *sc = buff;
-			*sc =  W25Qxx_SectorCount(); /* 4k sector number */
+			uint16_t n = W25Qxx_SectorCount();
+			*sc = (n > W25Qxx_RESERVED)?n - W25Qxx_RESERVED:n; /* 4k sector number, the reserved sectors keep the record journal */
 			}
 			break;
 		case GET_SECTOR_SIZE:
@@ -0,0 +1,51 @@
+/*
+ * actrack.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  AC power zero-cross tracker. The AC_ZERO signal resets TIM1 (see core.cpp), ACTRACK::zeroCross() is called from the TIM1 update
+ *  interrupt when the TIM1 has been reset by the trigger. The tracker measures the AC half-period by the TIM5 counter (10 mks ticks)
+ *  and keeps the TIM5 aligned to the zero-crossings in the background, so the iron power phases start at the AC half-period beginning.
+ *
+ *  The TIM5 phase error is the TIM5 counter value at the zero-cross relative to the nearest period half, the loop filter is the
+ *  proportional-integral one. The TIM5 counter is corrected at the zero-cross in the middle of TIM5 period only, far from CH3 and CH4 compare
+ *  events at the period bounds. Large phase error (at startup) is corrected at once.
+ *  The TIM5 period is 20 ms, two half-periods of 50 Hz AC line. In 60 Hz line the zero-cross drifts over the TIM5 period, so the tracker
+ *  measures the frequency only and does not correct the TIM5.
+ */
+
+#ifndef ACTRACK_H_
+#define ACTRACK_H_
+
+#include "main.h"
+#include "stat.h"
+
+class ACTRACK {
+	public:
+		ACTRACK(void)										{ }
+		void		init(void);
+		void		zeroCross(uint32_t ms);					// Called from TIM1 IRQ handler when AC_ZERO signal reset the TIM1
+		uint16_t	halfPeriod(void);						// AC half-period, 0.01 ms
+		uint16_t	frequency(void);						// AC frequency, 0.01 Hz or zero if unknown
+		uint16_t	jitter(void)							{ return (h_jitter.read() + 8) >> 4;			} // TIM5 ticks
+		int16_t		phaseError(void)						{ return phase_err;								} // TIM5 ticks
+		bool		isLocked(void)							{ return locked;								}
+	private:
+		EXPA		h_half;									// Exponential average of the AC half-period in TIM5 ticks, Q4
+		EXPA		h_jitter;								// Exponential average of half-period deviation in TIM5 ticks, Q4
+		uint32_t	ticks_hz		= 100000;				// TIM5 tick frequency
+		uint32_t	cnt_prev		= 0;					// The TIM5 counter at previous zero-cross
+		uint32_t	ms_prev			= 0;					// The time of previous zero-cross, ms
+		int32_t		corr			= 0;					// The TIM5 counter correction applied at previous zero-cross
+		int32_t		integral		= 0;					// The integral of the phase error
+		bool		half_ready		= false;				// The AC half-period has been measured
+		volatile	int16_t	phase_err	= 0;				// The last phase error, TIM5 ticks
+		volatile	bool	locked		= false;			// The TIM5 is aligned to AC zero-cross
+		const uint8_t	max_gap_ms		= 15;				// Maximum time between two zero-crossings to measure the half-period
+		const int32_t	coarse_err		= 50;				// The phase error to be corrected at once, TIM5 ticks
+		const int32_t	lock_err		= 5;				// Maximum phase error when the TIM5 is locked, TIM5 ticks
+		const int32_t	max_step		= 5;				// Maximum fine correction step, TIM5 ticks
+		const int32_t	max_integral	= 320;				// The integral limit
+};
+
+#endif
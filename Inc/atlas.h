@@ -0,0 +1,61 @@
+/*
+ * atlas.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The digit atlas of the numeric readouts. When the readout font is loaded, the symbols of ATLAS_SYMBOLS available in the font
+ *  are rendered once into the cells of the packed 1-bpp bitmap (atlas). Every cell is as wide as the widest symbol, rounded up to the byte boundary,
+ *  so the readout string is laid out in fixed-width cells and each cell is sent to the display directly from the atlas.
+ *  The atlas keeps the symbols shown in every readout (slot), identified by its position on the screen. When the readout is drawn again
+ *  with the same colors and layout, only the cells with changed symbols are redrawn.
+ *  The whole readout is drawn if it is new, its colors or its layout have been changed or the screen area has been invalidated.
+ */
+
+#ifndef ATLAS_H_
+#define ATLAS_H_
+
+#include "main.h"
+#include "tft.h"
+
+#define ATLAS_SYMBOLS		"0123456789-CF"					// The degree sign is drawn as an icon
+#define ATLAS_SYMBOLS_NUM	(13)
+#define ATLAS_SLOTS			(4)								// The maximum number of the readouts tracked
+#define ATLAS_LEN			(4)								// The maximum number of symbols in the readout
+
+class DIGIT_ATLAS {
+	public:
+		DIGIT_ATLAS(void)									{ }
+		void		build(u8gFont &font);					// Render the symbols with current font and font scale
+		void		draw(uint16_t x, uint16_t y, uint16_t width, const char *str, BM_ALIGN align, uint16_t bg_color, uint16_t fg_color);
+		void		invalidate(void);						// The whole screen has been changed
+		void		invalidate(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+		uint16_t	cellWidth(void)							{ return cell_w;								}
+		uint16_t	height(void)							{ return atlas.height();						}
+		uint32_t	pushedPixels(void)						{ return pushed;								}
+		void		resetStat(void)							{ pushed = 0;									}
+	private:
+		typedef struct s_readout {
+			uint16_t	x		= 0;
+			uint16_t	y		= 0;
+			uint16_t	width	= 0;
+			uint16_t	start	= 0;						// The offset of the first cell inside the readout area
+			uint16_t	bg		= 0;
+			uint16_t	fg		= 0;
+			int8_t		cell[ATLAS_LEN];					// The atlas cell index of the shown symbol, -1 is a blank cell
+			uint8_t		len		= 0;						// The number of the shown symbols
+			uint32_t	used	= 0;						// The last usage counter, to replace least recently used slot
+			bool		valid	= false;					// The readout matches the screen
+		} tReadout;
+		int8_t		cellIndex(char sym);
+		void		drawCell(uint16_t x, uint16_t y, int8_t cell, uint16_t bg_color, uint16_t fg_color);
+		tReadout&	readout(uint16_t x, uint16_t y, uint16_t width);
+		BITMAP		atlas;
+		int8_t		index[ATLAS_SYMBOLS_NUM];				// The atlas cell of the symbol or -1 if the symbol does not exist in the font
+		uint16_t	cell_w		= 0;						// The symbol advance, pixels
+		uint16_t	cell_stride	= 0;						// The cell width in the atlas, pixels
+		tReadout	slot[ATLAS_SLOTS];
+		uint32_t	use_cnt		= 0;
+		uint32_t	pushed		= 0;						// The number of pixels sent to the display
+};
+
+#endif
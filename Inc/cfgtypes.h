@@ -15,6 +15,9 @@
  *  2025 NOV 03, v.1.12
  *  	Added CFG_FAN_24 parameter into CFG_BIT_MASK enum to support Hot Air Gun with 12v fan
  *  	Changed the gun_fan_speed field in the RECORD structure from 16 bits to 8 bits long
+ *  2026 OCT 16, v.1.13
+ *  	Added heat_cap and heat_loss fields of the learned tip thermal model to the TIP structure
+ *  	Added CFG_GUN_SD parameter into CFG_BIT_MASK enum to select the Hot Air Gun sigma-delta power modulator
  */
 
 #ifndef CFGTYPES_H_
@@ -34,10 +37,12 @@
  * CFG_BIG_STEP		- The temperature step 1 degree (0) 5 degree (1)
  * CFG_DSPL_TYPE	- The display type IPS (true) or TFT (false)
  * CFG_SAFE_MODE	- Limit IRON high temperature
+ * CFG_FAN_24		- The Hot Air Gun fan voltage 24v (1) or 12v (0)
+ * CFG_GUN_SD		- The Hot Air Gun power modulation: sigma-delta (1) or power patterns (0)
  */
 typedef enum { CFG_CELSIUS = 1, CFG_BUZZER = 2, CFG_SWITCH = 4, CFG_AU_START = 8,
 				CFG_U_CLOCKWISE = 16, CFG_L_CLOCKWISE = 32, CFG_FAST_COOLING = 64, CFG_BIG_STEP = 128,
-				CFG_DSPL_TYPE = 256, CFG_SAFE_MODE = 512, CFG_FAN_24 = 1024 } CFG_BIT_MASK;
+				CFG_DSPL_TYPE = 256, CFG_SAFE_MODE = 512, CFG_FAN_24 = 1024, CFG_GUN_SD = 2048 } CFG_BIT_MASK;
 
 typedef enum { d_t12 = 0, d_jbc = 1, d_gun = 2, d_unknown } tDevice;
 
@@ -90,11 +95,14 @@ struct s_pid_params {
 };
 
 /*
- * Configuration data of each initialized tip are saved in the tipcal.dat file (16 bytes per tip record).
+ * Configuration data of each initialized tip are saved in the tipcal.dat file (20 bytes per tip record).
  * The tip configuration record has the following format:
  * 4 reference temperature points
  * tip status bitmap
  * tip suffix name
+ * the learned thermal model of the tip (see tmodel.h)
+ * The model fields are appended to the previous 16-bytes record. The tipcal.dat file of the current format starts with
+ * the 4-bytes header, "TIP2". The old file without header is converted by W25Q::checkTipFile()
  */
 typedef struct s_tip TIP;
 struct s_tip {
@@ -103,6 +111,8 @@ struct s_tip {
 	char		name[tip_name_sz];					// T12 or JBC tip name suffix, JL02 for T12-JL02 or 0.4IS for JBC-0.4IS
 	int8_t		ambient;							// The ambient temperature in Celsius when the tip being calibrated
 	uint8_t		crc;								// CRC checksum
+	uint16_t	heat_cap;							// The tip heat capacity, Q4, or zero if not learned
+	uint16_t	heat_loss;							// The tip heat loss coefficient, Q8, or zero if not learned
 };
 
 // This tip structure is used to show available tips when tip is activating
@@ -118,6 +128,8 @@ struct s_tip_list_item {
  * During controller initialization phase, the buildTipTable() function creates
  * the tip list in memory of all possible tips. If the tip is calibrated, i.e. has a record
  * in the tipcal.dat file on W25Qxx flash, the tip record saves tip record index in the file
+ * The table is kept up to date when the tip is activated or calibrated, so the tip list is built without the flash access.
+ * The tip records in use are cached by W25Q class (see flash.h)
  */
 typedef struct s_tip_table		TIP_TABLE;
 struct s_tip_table {
@@ -0,0 +1,50 @@
+/*
+ * compose.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The dirty-tile compositor of the display widgets. The widget is rendered into the BITMAP first (see display.cpp),
+ *  the compositor keeps the copy of the bitmap that is on the screen now (shadow bitmap) for the widget position.
+ *  When the widget is drawn again in the same place, the bitmap is split into the tiles of 8 pixels (one byte) wide and COMP_TILE_H rows high,
+ *  and only the tiles that differ from the shadow bitmap are sent to the display. The adjacent changed tiles in the tile row are merged
+ *  into the single rectangular area, so each merged area is sent by one TFT_StartDrawArea()/TFT_FinishDrawArea() transaction.
+ *  The whole bitmap is drawn if the widget is new, its colors have been changed or the screen area has been invalidated.
+ *
+ *  The screen content under the widget should not be changed by other drawing routines, or the area should be invalidated.
+ */
+
+#ifndef COMPOSE_H_
+#define COMPOSE_H_
+
+#include "main.h"
+#include "bitmap.h"
+
+#define COMP_SLOTS		(6)									// The maximum number of the widgets tracked
+#define COMP_TILE_H		(8)									// The tile height, pixels
+
+class COMPOSER {
+	public:
+		COMPOSER(void)										{ }
+		void		draw(uint16_t x, uint16_t y, BITMAP &bm, uint16_t bg_color, uint16_t fg_color);
+		void		invalidate(void);						// The whole screen has been changed
+		void		invalidate(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+		uint32_t	pushedPixels(void)						{ return pushed;								}
+		void		resetStat(void)							{ pushed = 0;									}
+	private:
+		typedef struct s_slot {
+			BITMAP		shadow;								// The copy of the bitmap that is on the screen
+			uint16_t	x		= 0;
+			uint16_t	y		= 0;
+			uint16_t	bg		= 0;
+			uint16_t	fg		= 0;
+			uint32_t	used	= 0;						// The last usage counter, to replace least recently used slot
+			bool		valid	= false;					// The shadow bitmap matches the screen
+		} tSlot;
+		int8_t		findSlot(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+		int8_t		newSlot(uint16_t width, uint16_t height);
+		tSlot		slot[COMP_SLOTS];
+		uint32_t	use_cnt		= 0;
+		uint32_t	pushed		= 0;						// The number of pixels sent to the display
+};
+
+#endif
@@ -40,6 +40,11 @@
  *  	Added CFG_CORE::minFanSpeed(), CFG_CORE::maxFanSpeed(), CFG_CORE::isFan24v(), CFG_CORE::gunFanPresetPcnt()
  *  	Modified CFG_CORE::gunFanPreset()
  *  	Added new parameter into CFG_CORE::setupGUN()
+ *  2026 OCT 16, v.1.13
+ *  	Added the tip thermal model fields into TIP_RECORD structure
+ *  	Added TIP_CFG::heatCapacity(), TIP_CFG::heatLoss(), TIP_CFG::loadModel() and CFG::saveTipModel()
+ *  	Added CFG_CORE::isGunSigmaDelta() and new parameter into CFG_CORE::setupGUN()
+ *  	Added CFG::fullTipName()
  */
 
 #ifndef CONFIG_H_
@@ -75,6 +80,7 @@ class CFG_CORE: public TIPS {
 		bool		isIPS(void)							{ return a_cfg.bit_mask & CFG_DSPL_TYPE;	}
 		bool		isSafeIronMode(void)				{ return a_cfg.bit_mask & CFG_SAFE_MODE;	}
 		bool		isFan24v(void)						{ return a_cfg.bit_mask & CFG_FAN_24;		}
+		bool		isGunSigmaDelta(void)				{ return a_cfg.bit_mask & CFG_GUN_SD;		}
 		uint8_t		getLowTO(void)						{ return a_cfg.t12_low_to; 					}	// 5-seconds intervals
 		uint8_t		getDsplBrightness(void)				{ return a_cfg.dspl_bright;					}	// 1-100%
 		uint8_t		getDsplRotation(void)				{ return a_cfg.dspl_rotation;				}
@@ -90,7 +96,7 @@ class CFG_CORE: public TIPS {
 		void		setup(bool buzzer, bool celsius, bool big_temp_step, bool i_enc, bool g_enc, bool ips_display, bool safe_iron_mode, uint8_t bright);
 		void		setupT12(bool reed, bool auto_start, uint8_t off_timeout, uint16_t low_temp, uint8_t low_to, uint8_t delta_temp, uint16_t duration);
 		void		setupJBC(uint8_t off_timeout, uint16_t stby_temp);
-		void		setupGUN(bool fast_gun_chill, bool is_fan_24v, uint8_t stby_timeout, uint16_t stby_temp);
+		void		setupGUN(bool fast_gun_chill, bool is_fan_24v, bool sigma_delta, uint8_t stby_timeout, uint16_t stby_temp);
 		void 		savePresetTempHuman(uint16_t temp_set, tDevice dev_type);
 		void		saveGunPreset(uint16_t temp, uint8_t fan = 101);
 		uint8_t		boostTemp(void);
@@ -122,6 +128,8 @@ struct s_TIP_RECORD {
 	uint16_t	calibration[4];
 	uint8_t		mask;
 	int8_t		ambient;
+	uint16_t	heat_cap;							// The learned tip thermal model, see tmodel.h
+	uint16_t	heat_loss;
 };
 
 class TIP_CFG {
@@ -138,7 +146,10 @@ class TIP_CFG {
 		void		applyTipCalibtarion(uint16_t temp[4], int8_t ambient, tDevice dev, bool calibrated);
 		void		resetTipCalibration(tDevice dev);
 		bool		isValidTipConfig(TIP *tip);
+		uint16_t	heatCapacity(tDevice dev);
+		uint16_t	heatLoss(tDevice dev);
 	protected:
+		void		loadModel(const TIP& tip, tDevice dev);
 		void 		defaultCalibration(tDevice dev = d_t12);
 		void		defaultCalibration(TIP *tip);
 	private:
@@ -153,7 +164,6 @@ class CFG : public W25Q, public CFG_CORE, public TIP_CFG, public BUZZER {
 	public:
 		CFG(void)				{ }
 		CFG_STATUS	init(void);
-		bool		reloadTips(void);
 		uint16_t	tempToHuman(uint16_t temp, int16_t ambient, tDevice dev);
 		uint16_t	humanToTemp(uint16_t temp, int16_t ambient, tDevice dev, bool no_lower_limit = false);
 		std::string tipName(tDevice dev);
@@ -167,12 +177,15 @@ class CFG : public W25Q, public CFG_CORE, public TIP_CFG, public BUZZER {
 		void		savePID(PIDparam &pp, tDevice dev = d_t12);
 		void 		initConfig(void);
 		bool		clearAllTipsCalibration(void);		// Remove tip calibration data
+		bool		saveTipModel(tDevice dev, uint16_t capacity, uint16_t loss);
 	private:
 		void		correctConfig(RECORD *cfg);
 		bool 		selectTip(tDevice dev_type, uint8_t index);
 		uint8_t		buildTipTable(TIP_TABLE tt[]);
 		std::string buildFullTipName(const uint8_t index);
+		void		fullTipName(const uint8_t index, char full_name[]);	// Build full tip name without memory allocation
 		TIP_TABLE	*tip_table = 0;						// Tip table - chunk number of the tip or 0xFF if does not exist in the EEPROM
+		const uint8_t	model_diff_shift	= 4;		// Save the tip model if it has changed more than 1/16
 };
 
 #endif
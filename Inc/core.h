@@ -10,10 +10,24 @@
 
 #include <stdbool.h>
 #include "main.h"
+#include "isrprof.h"
+#include "telemetry.h"
 
 // Forward function declaration
 bool 		isACsine(void);
 uint16_t	gtimPeriod(void);
+uint16_t	acFrequency(void);
+uint16_t	acJitter(void);
+bool		isACLocked(void);
+uint32_t	isrWorstCycles(tPrfStage stage);
+uint32_t	isrBudgetCycles(void);
+void		isrResetProfile(void);
+uint16_t	telemetryRate(tTlmPhase phase);
+uint16_t	telemetryAvgPower(tTlmPhase phase);
+uint16_t	telemetryMaxPower(tTlmPhase phase);
+uint16_t	telemetryRipple(tTlmPhase phase);
+uint32_t	telemetryDropped(void);
+uint32_t	schedLateness(void);
 
 #ifdef __cplusplus
 extern "C" {
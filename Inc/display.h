@@ -16,6 +16,16 @@
  *  	Added DSPL::drawGunStandby()
  *  2024 NOV 05, v.1.08
  *  	Implemented the pre-heat phase in calibration modes: modified the DSPL::calibShow() and DSPL::calibManualShow()
+ *  2026 OCT 16, v.1.13
+ *  	Added DSPL::debugISR() to show the control path IRQ handlers duration in debug mode
+ *  	Added DSPL::debugAC() to show AC line frequency and main loop tasks lateness in debug mode
+ *  	Added DSPL::debugTelemetry() to show the control path telemetry of the iron in debug mode
+ *  	Added DSPL::debugRefresh() to show the display frames per second, SPI bus utilization and glyph cache hit rate in debug mode
+ *  	Added DSPL::comp, the dirty-tile compositor of the temperature, preset temperature and power widgets
+ *  	Added DSPL::atl_temp and DSPL::atl_value, the digit atlases of the temperature and preset temperature readouts
+ *  	DSPL::pidShowGraph() draws the ring-indexed graph and redraws the columns of the new samples only
+ *  	DSPL is the retained scene (see scene.h): the drawing primitives register the screen nodes, DSPL::clear() starts new frame
+ *  	DSPL inherits the display class as protected, so the screen cannot be drawn through the base class bypassing the scene
  */
 
 #ifndef DISPLAY_H_
@@ -29,6 +39,9 @@
 #include "font.h"
 #include "nls.h"
 #include "tools.h"
+#include "compose.h"
+#include "atlas.h"
+#include "scene.h"
 
 // TFT brightness control class
 #define TFT_TIM		htim12
@@ -51,7 +64,7 @@ class BRGT {
 
 typedef enum { u_lower = 0, u_upper = 1, u_extra = 2, u_none = 3 } tUnitPos;
 
-class DSPL : public tft_ILI9341, public BRGT, public GRAPH, public NLS_MSG {
+class DSPL : protected tft_ILI9341, public BRGT, public GRAPH, public NLS_MSG, public SCENE {
 	public:
 					DSPL(void) : tft_ILI9341()				{ }
 		virtual		~DSPL()									{ }
@@ -106,6 +119,29 @@ class DSPL : public tft_ILI9341, public BRGT, public GRAPH, public NLS_MSG {
 		void 		showVersion(void);
 		void		debugShow(uint16_t data[12], bool t12_on, bool jbc_on, bool gun_on, bool t12_connected, bool jbc_connected, bool gun_connected, bool gun_reed, bool jbc_stby, bool jbc_change, bool gtim_ok);
 		void		debugMessage(const char *msg, uint16_t x, uint16_t y, uint16_t len);
+		void		debugISR(uint32_t worst, uint32_t budget);
+		void		debugAC(uint16_t freq, uint16_t jitter, bool locked, uint32_t late);
+		void		debugTelemetry(uint16_t rate, uint16_t avg_power, uint16_t max_power, uint16_t ripple, uint32_t dropped);
+		void		debugRefresh(uint16_t fps, uint8_t bus_load, uint32_t glyph_hits, uint32_t glyph_misses);
+#ifdef UI_RETAINED
+		// The drawing primitives register the nodes of the retained scene and skip the nodes already shown.
+		// Every display primitive used by DSPL should be wrapped here; the pixmap of the PID graph is drawn inside the widget node
+		void 		fillScreen(uint16_t color);
+		void 		drawHLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
+		void 		drawVLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
+		void 		drawFilledRect(uint16_t x0, uint16_t y0, uint16_t width, uint16_t height, uint16_t color);
+		void 		drawCircle(uint16_t x, uint16_t y, uint8_t radius, uint16_t color);
+		void		drawFilledCircle(uint16_t x, uint16_t y, uint8_t radius, uint16_t color);
+		void 		drawRoundRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color);
+		void		drawFilledTriangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color);
+		void		drawIcon(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height, const uint8_t *bitmap, uint16_t bm_width, uint16_t bg_color, uint16_t fg_color);
+		void		drawBitmapArea(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height, BITMAP& bm, uint16_t bg_color, uint16_t fg_color);
+		void		drawBitmap(uint16_t x0, uint16_t y0, BITMAP& bm, uint16_t bg_color, uint16_t fg_color);
+		u8g2_uint_t drawStr(u8g2_uint_t x, u8g2_uint_t y, const char *str, uint16_t color);
+		u8g2_uint_t drawUTF8(u8g2_uint_t x, u8g2_uint_t y, const char *str, uint16_t color);
+	protected:
+		virtual void eraseArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+#endif
 	private:
 		void		checkBox(BITMAP &bm, uint16_t x, uint8_t size, bool checked);
 		void		drawTemp(uint16_t temp, uint16_t x, uint16_t y, bool celsius);
@@ -113,6 +149,8 @@ class DSPL : public tft_ILI9341, public BRGT, public GRAPH, public NLS_MSG {
 		void		drawHGauge(uint16_t len, uint16_t g_width, uint16_t x, uint16_t y, uint16_t g_color, int16_t label = -1, uint8_t intervals = 0);
 		void		drawValue(uint16_t value, uint16_t x, uint16_t y, BM_ALIGN align, uint16_t color);
 		void		update(void);
+		void		pidGraphColumn(uint16_t col, int16_t max_t, uint16_t max_d, uint16_t d_height);
+		void		damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height);
 		uint8_t*	letter_font			= (uint8_t*)u8g_font_profont22r;
 		uint16_t	bg_color			= 0;
 		uint16_t	fg_color			= 0xFFFF;
@@ -125,6 +163,13 @@ class DSPL : public tft_ILI9341, public BRGT, public GRAPH, public NLS_MSG {
 		BITMAP		bm_temp, bm_preset, bm_adc_read, bm_gauge;
 		BITMAP		bm_calib_power;							// Used to draw the applied power during calibration procedure
 		PIXMAP		pm_graph;
+		uint32_t	graph_shown			= 0;				// The number of graph samples drawn in pm_graph
+		int16_t		graph_max_t			= 0;				// The normalization of the graph drawn
+		uint16_t	graph_max_d			= 0;
+		bool		graph_valid			= false;			// The graph on the screen matches pm_graph
+		COMPOSER	comp;									// Sends changed tiles of the dashboard widgets only
+		DIGIT_ATLAS	atl_temp;								// The big digits of the temperature readouts
+		DIGIT_ATLAS	atl_value;								// The letter font digits of the preset temperature readouts
 		uint8_t		pwr_pcnt			= 255;				// The power percent applied
 		uint16_t	gun_temp_y			= 150;				// Y coordinate of hot air gun coordinate (depends on screen orientation)
 		uint16_t	fan_icon_x			= 0;				// Fan animated icon coordinates
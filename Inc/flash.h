@@ -7,6 +7,12 @@
  * 	   Added keep_mounted flag
  *	2025 NOV 04, v.1.12
  *		Added W25Q::rw flag indicating the active file write enabled
+ *	2026 OCT 16, v.1.13
+ *		Added W25Q::countTips(), W25Q::upgradeTips() and tip_v1_size constant to convert old tipcal.dat file
+ *		Added W25Q::jrnl, the record journal (see journal.h), W25Q::exportJournal(), W25Q::dropJournal() and W25Q::findTip()
+ *		Added the tip record cache, W25Q::cachedTip(), W25Q::cacheTip() and W25Q::dropTipCache()
+ *		Added the tip record index hint to W25Q::saveTipData()
+ *		The tipcal.dat file starts with the header, tip_magic. Added W25Q::checkTipFile(), W25Q::tipFileFormat() and W25Q::tipOffset()
  *
  */
 
@@ -16,8 +22,12 @@
 #include "cfgtypes.h"
 #include "ff.h"
 #include "vars.h"
+#include "journal.h"
+
+#define W25Q_TIP_CACHE	(4)									// The number of cached tip records: T12, JBC, Hot Air Gun and the tip being edited
 
 typedef enum tip_io_status	{TIP_OK = 0, TIP_IO, TIP_CHECKSUM, TIP_INDEX} TIP_IO_STATUS;
+typedef enum tip_file_fmt	{TIP_FILE_NONE = 0, TIP_FILE_OLD, TIP_FILE_CURRENT} TIP_FILE_FMT;
 typedef enum active_file  	{W25Q_NOT_MOUNTED = 0, W25Q_NONE, W25Q_TIPS_CURRENT, W25Q_TIPS_BACKUP, W25Q_CONFIG_CURRENT, W25Q_CONFIG_BACKUP} ACT_FILE;
 
 class W25Q {
@@ -33,15 +43,27 @@ class W25Q {
 		bool			loadPIDparams(PID_PARAMS* pid_params);
 		bool			savePIDparams(PID_PARAMS* pid_params);
 		TIP_IO_STATUS	loadTipData(TIP* tip, uint8_t tip_index, bool keep = false);
-		int16_t 		saveTipData(TIP* tip, bool keep = false); // Return tip index in the file or -1 if error
+		int16_t 		saveTipData(TIP* tip, bool keep = false, int16_t hint = -1); // Return tip index in the file or -1 if error
 		bool			formatFlashDrive(void);
 		bool			clearTips(void);
 		bool			clearConfig(void);
 		bool			canDelete(const TCHAR *file_name);
 		const TCHAR*	fileName(uint8_t index);
+		bool			exportJournal(void);					// Write the journal records into the configuration files
+		bool			dropJournal(void);						// Erase the journal, the configuration files become actual
+		void			checkTipFile(void);						// Convert the old tipcal.dat file, restore it from the backup if no correct record
 		void			keepMounted(bool keep)					{ keep_mounted = keep; }
 	private:
 		TIP_IO_STATUS	returnStatus(bool keep, TIP_IO_STATUS ret_code);
+		TIP_FILE_FMT	tipFileFormat(void);					// The format of tipcal.dat file, checked by the file header
+		uint16_t		countTips(TIP_FILE_FMT fmt);			// The number of tip records with correct CRC
+		FSIZE_t			tipOffset(uint16_t tip_index)			{ return sizeof(tip_magic) + (FSIZE_t)tip_index * sizeof(TIP); }
+		int16_t			findTip(const char *name);				// The tip record index or the index of the new record
+		bool			writeFile(const TCHAR *fn, void *data, UINT size);
+		bool			upgradeTips(void);						// Convert tipcal.dat file from the old format
+		bool			cachedTip(TIP* tip, uint8_t tip_index);	// Copy the tip record from the cache
+		void			cacheTip(const TIP* tip, uint8_t tip_index);
+		void			dropTipCache(void);
 		uint8_t 		TIP_checkSum(TIP* tip, bool write);
 		uint8_t			CFG_checkSum(RECORD* cfg, bool write);
 		uint8_t			PID_checkSum(PID_PARAMS* pid_params, bool write);
@@ -49,6 +71,11 @@ class W25Q {
 		bool			keep_mounted	= false;
 		bool			rw				= false;				// Open file for read/write
 		FIL				cfg_f;
+		JOURNAL			jrnl;
+		TIP				tip_cache[W25Q_TIP_CACHE];				// The recently used tip records
+		uint8_t			cache_index[W25Q_TIP_CACHE]	= {0};		// The tip record index in the file of the cached record
+		uint32_t		cache_used[W25Q_TIP_CACHE]	= {0};		// The cache entry use stamp, zero if the entry is free
+		uint32_t		cache_cnt		= 0;
 		ACT_FILE		act_f = W25Q_NOT_MOUNTED;				// Open file
 		const uint16_t	blk_size		= 4096;
 		const TCHAR*	fn_tip_calib	= "tipcal.dat";
@@ -56,6 +83,8 @@ class W25Q {
 		const TCHAR*	fn_cfg			= "config.dat";
 		const TCHAR*	fn_cfg_backup	= "config.bak";
 		const TCHAR*	fn_pid			= "pid.dat";
+		const UINT		tip_v1_size		= 16;					// The tip record size before v.1.13
+		const uint32_t	tip_magic		= 0x32504954;			// "TIP2", the header of the tipcal.dat file of the current format
 };
 
 #endif
@@ -1,6 +1,8 @@
 /*
  * graph.h
  *
+ * 2026 OCT 16, v.1.13
+ *  	Added GRAPH::count(), GRAPH::tempAt() and GRAPH::dispAt() to draw the graph incrementally by the ring buffer index
  */
 
 #ifndef GRAPH_H_
@@ -13,12 +15,16 @@ class GRAPH {
 		GRAPH(void)											{ }
 		bool		isFull(void)							{ return full_buff; 					}
 		uint16_t	dataSize(void)							{ return (full_buff)?size:data_index;	}
-		void		reset(void)								{ data_index = 0; full_buff = false;	}
+		uint16_t	capacity(void)							{ return size;							}
+		uint32_t	count(void)								{ return total;							} // The number of samples put since reset
+		void		reset(void)								{ data_index = 0; full_buff = false; total = 0;	}
 		bool		allocate(uint16_t size);
 		void		freeData(void);
 		void		put(int16_t t, uint16_t d);
 		int16_t		temp(uint16_t index);
 		uint16_t	disp(uint16_t index);
+		int16_t		tempAt(uint16_t pos)					{ return (pos < size)?h_temp[pos]:0;	} // By the position in the ring buffer
+		uint16_t	dispAt(uint16_t pos)					{ return (pos < size)?h_disp[pos]:0;	}
 	private:
 		uint16_t	indx(uint16_t i);
 		uint16_t	size				= 0;				// The graph size
@@ -26,6 +32,7 @@ class GRAPH {
 		uint16_t	*h_disp				= 0;				// The dispersion  history data, allocated later
 		uint16_t	data_index			= 0;				// The index in the array to put new data
 		bool		full_buff			= false;			// Whether the history data buffer is full
+		uint32_t	total				= 0;				// The number of samples put since reset, the sample k is at k % size position
 };
 
 #endif
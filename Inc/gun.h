@@ -34,6 +34,10 @@
  *  	Changed HOTGUN::min_fan_speed and HOTGUN::max_fan_speed from constants to variables
  *  	Added HOTGUN::setFanLimits() to setup the fan speed limits
  *  	Removed HOTGUN::fanStepPcnt(void), HOTGUN::minFanSpeed() and HOTGUN::maxFanSpeed()
+ *  2026 OCT 16, v.1.13
+ *  	Added HOTGUN::pid_q constant, the PID coefficient denominator power
+ *  	Added HOTGUN::fine_power, the required power with fractional part, to be applied by the sigma-delta modulator (see core.cpp)
+ *  	Added HOTGUN::setSigmaDelta(), HOTGUN::isSigmaDelta(), HOTGUN::finePower() and HOTGUN::pidPower()
  */
 
 #ifndef GUN_H_
@@ -44,6 +48,7 @@
 #include "unit.h"
 
 #define FAN_TIM		htim11
+#define GUN_POWER_Q	(4)										// The fractional bits of the fine Hot Air Gun power
 extern TIM_HandleTypeDef FAN_TIM;
 
 class HOTGUN : public UNIT {
@@ -63,6 +68,9 @@ class HOTGUN : public UNIT {
 		virtual void		setTemp(uint16_t temp)			{ temp_set	= constrain(temp, 0, int_temp_max);	}
 		void				setFan(uint16_t fan)			{ fan_speed = constrain(fan, min_fan_speed, max_fan_speed);	}
 		void				setFastGunCooling(bool on)		{ fast_cooling = on;							}
+		void				setSigmaDelta(bool on)			{ sigma_delta = on;								}
+		bool				isSigmaDelta(void)				{ return sigma_delta;							}
+		uint16_t			finePower(void)					{ return fine_power;							} // Q4, see power()
 		void				setFanLimits(uint16_t min_speed, uint16_t max_speed);
 		void				fanFixed(uint16_t fan);
 		void				fanControl(bool on);
@@ -80,12 +88,14 @@ class HOTGUN : public UNIT {
 		void        		lowPowerMode(uint16_t t);		// Activate low power mode (preset temp.) To disable, use switchPower(true)
     private:
 		void		shutdown(void);
+		int32_t		pidPower(int16_t t_set, int16_t t);		// The PID required power, GUN_POWER_Q
 		void		regMinCoolingTemp(void)					{ min_cool_temp	= avg_sync_temp; min_cool_tm = HAL_GetTick(); }
 		PowerMode	mode				= POWER_OFF;
 		uint8_t    	fix_power			= 0;				// Fixed power value of the Hot Air Gun (or zero if off)
 		bool		chill				= false;			// Chill the Hot Air gun if it is over heating
 		bool		reach_cold_temp		= true;				// Flag indicating the Hot Air Gun has reached the 'temp_gun_cold' temperature
 		bool		fast_cooling		= false;			// Flag indicating maximum fan speed when cooling
+		bool		sigma_delta			= false;			// Use the sigma-delta power modulator instead of power patterns
 		uint16_t	temp_set			= 0;				// The preset temperature of the hot air gun (internal units)
 		uint16_t	fan_speed			= 0;				// Preset fan speed
 		uint16_t	low_temp			= 0;				// The temperature in standby mode (if not zero)
@@ -103,9 +113,11 @@ class HOTGUN : public UNIT {
 		volatile    uint16_t	avg_sync_temp	= 0;		// Average temperature synchronized with TIM1 (used to calculate required power, see power() method)
 		volatile 	uint8_t		relay_ready_cnt	= 0;		// The relay ready counter, see HOTHUN::power()
 		volatile	uint16_t	applied_power	= 0;		// Calculated value of power to be applied (see power())
+		volatile	uint16_t	fine_power		= 0;		// Calculated value of power with fractional part, GUN_POWER_Q
 		bool		relay_activated				= false;	// The relay activated flag
         const       uint8_t     max_fix_power 	= 70;
 		const		uint8_t		max_power		= 120;
+		static const uint8_t	pid_q			= 13;		// The PID coefficient denominator power of 2 (13 means 8192)
 		const		uint16_t	max_cool_fan	= 1600;
         const       uint16_t    temp_gun_off   	= 125;		// (50) The temperature of the cold Hot Air Gun
         const		uint32_t	fan_off_timeout	= 6*60*1000;// The timeout to turn the fan off in cooling mode
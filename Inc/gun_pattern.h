@@ -0,0 +1,76 @@
+/*
+ * gun_pattern.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The Hot Air Gun power distribution patterns, see core.cpp
+ *  The gun power (0-120) is the number of active AC half-period shapes in 120-slots pattern. All 121 patterns are built by the compiler
+ *  and saved as bit masks (15 bytes per pattern), so the DMA interrupt handler just expands the bit mask into the PWM data buffer.
+ *  The pattern is built by the same algorithm as the former calculateGunPowerData() routine: the active shapes (or the inactive shapes
+ *  if the power is greater than a half of maximum) are distributed evenly, each one in the center of its slot.
+ *  GUN_PATTERN::verify() checks the number of active shapes in every pattern at compile time.
+ */
+
+#ifndef GUN_PATTERN_H_
+#define GUN_PATTERN_H_
+
+#include <stdint.h>
+
+#define GUN_SLOTS		(120)
+#define GUN_MASK_SIZE	(GUN_SLOTS / 8)
+
+class GUN_PATTERN {
+	public:
+		constexpr GUN_PATTERN(void) : mask() {
+			for (uint8_t pwr = 0; pwr <= GUN_SLOTS; ++pwr)
+				build(pwr);
+		}
+		constexpr const uint8_t*	pattern(uint8_t pwr) const	{ return mask[(pwr > GUN_SLOTS)?GUN_SLOTS:pwr];	}
+		constexpr bool	isActive(uint8_t pwr, uint8_t slot) const	{ return (pattern(pwr)[slot >> 3] >> (slot & 7)) & 1;	}
+		constexpr bool	verify(void) const {
+			for (uint8_t pwr = 0; pwr <= GUN_SLOTS; ++pwr) {
+				uint8_t active = 0;
+				for (uint8_t i = 0; i < GUN_SLOTS; ++i)
+					if (isActive(pwr, i)) ++active;
+				if (active != pwr) return false;
+			}
+			return true;
+		}
+	private:
+		constexpr void	set(uint8_t pwr, uint8_t slot, bool on) {
+			if (on) mask[pwr][slot >> 3] |= (1 << (slot & 7));
+		}
+		constexpr void	build(uint8_t pwr) {
+			bool	on		= true;
+			uint8_t	p		= pwr;
+			if (p > (GUN_SLOTS >> 1)) {						// Calculate positions of "empty" peaks
+				on	= false;
+				p	= GUN_SLOTS - p;
+			}
+			if (p == 0) {
+				for (uint8_t i = 0; i < GUN_SLOTS; ++i)
+					set(pwr, i, !on);
+				return;
+			}
+			uint8_t slots	= GUN_SLOTS / p;				// Number of slots per each "powered" peak
+			uint8_t remain	= GUN_SLOTS % p;				// The division remainder
+			uint8_t pos		= slots >> 1;					// Put the "powered" peak in to the center of the slot
+			int8_t	extra	= 0;							// Extra position remainder (extra/p)
+			for (uint8_t i = 0; i < GUN_SLOTS; ++i) {
+				if (i < pos) {
+					set(pwr, i, !on);
+				} else {
+					set(pwr, i, on);
+					pos += slots;
+					extra += remain;
+					if (extra + (remain>>1) >= p) {
+						++pos;
+						extra -= p;
+					}
+				}
+			}
+		}
+		uint8_t		mask[GUN_SLOTS+1][GUN_MASK_SIZE];
+};
+
+#endif
@@ -14,6 +14,8 @@
  *		Separate ambientTemp() into two routines to calculate stm32 temperature and steinhart sensor temperature inside Hakko T12 handle
  *		Save MCU internal temperature at startup to adjust internal temperature. As soon as the MCU temperature is higher than actual ambient temperature,
  *		return average value between MCU temperature and MCU temperature at startup.
+ *  2026 OCT 16, v.1.13
+ *  	Added HW::refresh, the refresh governor of the dashboard
  */
 
 #ifndef HW_H_
@@ -31,6 +33,7 @@
 #include "config.h"
 #include "buzzer.h"
 #include "nls_cfg.h"
+#include "refresh.h"
 
 extern TIM_HandleTypeDef htim3;
 extern TIM_HandleTypeDef htim4;
@@ -55,6 +58,7 @@ class HW {
 		RENC		u_enc, l_enc;							// Upper encoder and lower encoder
 		HOTGUN		hotgun;
 		BUZZER		buzz;
+		REFRESH		refresh;								// The dashboard refresh governor
 	private:
 		int32_t 			internalTemp(int32_t raw_stm32);
 		int32_t 			steinhartTemp(int32_t raw_ambient);
@@ -11,6 +11,9 @@
  *    Changed the IRON::sw_jbc_len from 10 to 15
  * 2024 OCT 06, v.1.07
  *    Changed the IRON::sw_jbc_len from 15 to 13
+ * 2026 OCT 16, v.1.13
+ *    Added pid_q constant, the PID coefficient denominator power
+ *    Added the learned tip thermal model (see tmodel.h) to calculate the feed-forward power
  *
  */
 
@@ -19,6 +22,7 @@
 
 #include "unit.h"
 #include "cfgtypes.h"
+#include "tmodel.h"
 
 class IRON : public UNIT {
 	public:
@@ -47,6 +51,9 @@ class IRON : public UNIT {
 		void				reset(void);					// Iron is disconnected, clear the temp history
 		void        		lowPowerMode(uint16_t t);		// Activate low power mode (preset temp.) To disable, use switchPower(true)
 		void				boostPowerMode(uint16_t t);		// Activate boost power mode
+		void				setModel(uint16_t capacity, uint16_t loss)	{ model.init(capacity, loss);		}
+		uint16_t			heatCapacity(void)				{ return model.capacity();						}
+		uint16_t			heatLoss(void)					{ return model.loss();							}
 	private:
 		uint16_t 	temp_set				= 0;			// The temperature that should be kept
 		uint16_t	temp_low				= 0;			// The temperature in low power mode (if not zero)
@@ -62,6 +69,7 @@ class IRON : public UNIT {
 		EXPA		d_power;								// Exponential average of power math dispersion
 		EXPA		d_temp;									// Exponential temperature math dispersion
 		EXPA		t_iron_short;							// Exponential average of the IRON temperature (short period)
+		TMODEL		model;									// The learned thermal model of the tip
 		bool		t_reset					= false;		// The temperature value was reset
 		uint16_t	max_power      			= 0;			// Maximum power of the T12 or JBC IRON, initialized in init() method
 		const uint16_t	max_fix_power  		= 1000;			// Maximum power in fixed power mode
@@ -77,6 +85,8 @@ class IRON : public UNIT {
 		const uint8_t	sw_tilt_len			= 2;
 		const uint8_t 	sw_jbc_len			= 13;			// JBC IRON switches history length
 		const int32_t	stable				= 20000;	// The power value when the Iron reaches the preset temperature. Used in PID::pidStable()
+		const uint16_t	model_stable_disp	= 16;			// Maximum temperature dispersion to learn the tip heat loss
+		static const uint8_t pid_q			= 11;			// The PID coefficient denominator power of 2 (11 means 2048)
 };
 
 #endif
@@ -0,0 +1,72 @@
+/*
+ * isrprof.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  ISR execution time profiler of the hard real-time control path (see core.cpp):
+ *  HAL_TIM_OC_DelayElapsedCallback() -> adcStartTemp() -> HAL_ADC_ConvCpltCallback() -> IRON::power()
+ *  The time is measured by the Cortex-M4 cycle counter (DWT CYCCNT) in MCU clock cycles.
+ *  For each stage the profiler keeps minimum, maximum, number of measurements and the histogram.
+ *  The histogram bin 'i' counts the measurements less than (PRF_BIN_BASE << i) cycles, the last bin counts the rest.
+ *
+ *  The profiler is enabled by ISR_PROFILE macro, see main.h.
+ *  If the macro is not defined, all methods are empty and the compiler removes the profiler code completely.
+ *  The classes are visible to C++ only, C modules (main.c includes core.h) see the stage enumeration only.
+ */
+
+#ifndef ISRPROF_H_
+#define ISRPROF_H_
+
+#include "main.h"
+
+#define PRF_BINS		(8)
+#define PRF_BIN_BASE	(256)
+
+typedef enum { PRF_TIM_OC = 0, PRF_ADC_START, PRF_ADC_CPLT, PRF_IRON_POWER, PRF_TEMP_PATH, PRF_LAST } tPrfStage;
+
+#ifdef __cplusplus
+class ISRSTAT {
+	public:
+		ISRSTAT(void)										{ reset();										}
+		void			reset(void);
+		void			update(uint32_t cycles);
+		uint32_t		min(void)							{ return (count)?c_min:0;						}
+		uint32_t		max(void)							{ return c_max;									}
+		uint32_t		number(void)						{ return count;									}
+		uint32_t		bin(uint8_t i)						{ return (i < PRF_BINS)?hist[i]:0;				}
+	private:
+		volatile uint32_t	c_min;							// Minimum registered cycles
+		volatile uint32_t	c_max;							// Maximum registered cycles
+		volatile uint32_t	count;							// The number of measurements
+		volatile uint32_t	hist[PRF_BINS];					// The histogram of measurements
+};
+
+class ISRPROF {
+	public:
+		ISRPROF(void)										{ }
+#ifdef ISR_PROFILE
+		void			init(void);
+		uint32_t		start(void)							{ return DWT->CYCCNT;							}
+		void			stop(tPrfStage stage, uint32_t begin)	{ stat[stage].update(DWT->CYCCNT - begin);	}
+		void			reset(void);
+		uint32_t		worst(tPrfStage stage)				{ return stat[stage].max();						}
+		uint32_t		best(tPrfStage stage)				{ return stat[stage].min();						}
+		uint32_t		bin(tPrfStage stage, uint8_t i)		{ return stat[stage].bin(i);					}
+		uint32_t		budget(void);						// The temperature path window (CCR4 to TIM5 period end) in MCU cycles
+	private:
+		ISRSTAT			stat[PRF_LAST];
+#else
+		void			init(void)							{ }
+		uint32_t		start(void)							{ return 0;										}
+		void			stop(tPrfStage stage, uint32_t begin)	{ }
+		void			reset(void)							{ }
+		uint32_t		worst(tPrfStage stage)				{ return 0;										}
+		uint32_t		best(tPrfStage stage)				{ return 0;										}
+		uint32_t		bin(tPrfStage stage, uint8_t i)		{ return 0;										}
+		uint32_t		budget(void)						{ return 0;										}
+#endif
+};
+
+#endif
+
+#endif
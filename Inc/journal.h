@@ -0,0 +1,99 @@
+/*
+ * journal.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The log-structured record journal on the W25Qxx flash. The configuration record, PID parameters and tip calibration records
+ *  are appended to the journal instead of rewriting the FatFS files, so the record saving takes one page program operation
+ *  and the flash wear is spread over the journal area.
+ *
+ *  The journal occupies the last W25Qxx_RESERVED sectors of the flash (not used by FatFS, see diskio.c). The sectors are used as a ring.
+ *  Every sector starts with the header (magic, sequence number and its complement), the records are appended one by one, 4-bytes aligned.
+ *  The record has the header (type, key, data size, sequence number, CRC-32 of the header and data) followed by the data.
+ *  The key is the tip index in the tipcal.dat file for the tip records and zero for other records.
+ *  When the same record is saved several times, the record with the greatest sequence number is the actual one.
+ *  The clear record (jr_clear, the key is the cleared record type) removes all the records of this type saved before.
+ *
+ *  The record with wrong CRC (the power was lost while the record being written) is ignored. The record header with wrong size means
+ *  the rest of the sector cannot be used; the next record is written to the next sector.
+ *
+ *  The in-memory index keeps the location of the actual record for every type and key, it is built by init() when the flash mounted.
+ *  When the new sector is required and the ring has less than two free sectors, the garbage collector moves actual records of the oldest sector
+ *  to the current one (keeping their sequence numbers) and erases the oldest sector. So the free sector is always available for the garbage collector.
+ *
+ *  The FatFS files (config.dat, pid.dat, tipcal.dat) are kept as the export view: W25Q::exportJournal() writes the actual records into the files.
+ *  The journal is used only when the FatFS volume does not occupy the reserved sectors (the flash formatted after v.1.13). Otherwise
+ *  the journal is inactive and the records are saved to the files as before.
+ */
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#include "main.h"
+
+#define JRNL_MAGIC		(0x4C4E524AU)						// "JRNL"
+#define JRNL_SECTOR		(4096)								// The W25Qxx sector size
+#define JRNL_TIPS		(255)								// The maximum number of the tip records (the tip index is uint8_t)
+#define JRNL_MAX_DATA	(64)								// The maximum record data size
+
+typedef enum { jr_config = 0, jr_pid, jr_tip, jr_clear, jr_last } tJrnlType;
+
+class JOURNAL {
+	public:
+		JOURNAL(void)										{ }
+		bool		init(uint16_t first_sector, uint16_t count);	// Scan the journal area, build the index
+		bool		format(uint16_t first_sector, uint16_t count);	// Erase the journal area
+		bool		isActive(void)							{ return active;								}
+		bool		has(tJrnlType type, uint8_t key)		{ return location(type, key) > 0;				}
+		bool		load(tJrnlType type, uint8_t key, void *data, uint16_t size);
+		bool		save(tJrnlType type, uint8_t key, const void *data, uint16_t size);
+		bool		clear(tJrnlType type);					// Remove all the records of the type
+		uint16_t	tipSlots(void);							// The greatest tip index in the journal plus one
+	private:
+		typedef struct s_jrnl_sector {
+			uint32_t	magic;
+			uint32_t	seq;
+			uint32_t	n_seq;								// ~seq
+			uint32_t	reserved;
+		} tJrnlSector;
+		typedef struct s_jrnl_rec {
+			uint8_t		type;								// tJrnlType, 0xFF in the free area
+			uint8_t		key;
+			uint16_t	size;								// Data size
+			uint32_t	seq;
+			uint32_t	crc;								// CRC-32 of the previous header fields and the data
+		} tJrnlRec;
+		typedef struct s_jrnl_buff {
+			tJrnlRec	hdr;
+			uint8_t		data[JRNL_MAX_DATA];
+		} tJrnlBuff;
+		uint32_t	address(uint16_t loc)					{ return ((uint32_t)first << 12) + ((uint32_t)(loc - 1) << 2);	}
+		uint16_t	loc(uint8_t sector, uint16_t offset)	{ return (((uint32_t)sector * JRNL_SECTOR + offset) >> 2) + 1;	}
+		static uint16_t	recSize(uint16_t size)				{ return (sizeof(tJrnlRec) + size + 3) & ~3;	}
+		uint16_t	location(tJrnlType type, uint8_t key);
+		void		setLocation(tJrnlType type, uint8_t key, uint16_t l);
+		bool		readSector(uint8_t sector, tJrnlSector &hdr);
+		int8_t		readRecord(uint32_t addr, tJrnlBuff &rec);	// 1 - correct record, 0 - wrong CRC, -1 - no more records in the sector
+		uint32_t	recordSeq(uint16_t l);
+		void		index(tJrnlBuff &rec, uint16_t l);		// Update the index by the record scanned
+		void		drop(tJrnlType type, uint32_t seq);		// Remove the records of the type older than seq from the index
+		bool		append(tJrnlBuff &rec);					// Write the record to the current sector, open next sector if necessary
+		bool		openNext(void);
+		bool		collect(void);							// Move actual records of the oldest sector and erase it
+		bool		isErased(uint8_t sector);
+		uint16_t	first		= 0;						// The first sector of the journal area
+		uint8_t		sectors		= 0;						// The number of the journal sectors
+		uint8_t		head		= 0;						// The current sector to write the records
+		uint8_t		tail		= 0;						// The oldest sector
+		uint8_t		used		= 0;						// The number of sectors in use
+		uint16_t	head_off	= JRNL_SECTOR;				// The free area offset in the current sector
+		uint32_t	seq			= 1;						// The next sequence number
+		bool		active		= false;
+		uint16_t	cfg_loc		= 0;						// The record locations in 4-bytes words from the journal start plus one, zero if no record
+		uint16_t	pid_loc		= 0;
+		uint16_t	tip_loc[JRNL_TIPS];
+		uint16_t	clr_loc[jr_clear];						// The locations of the last clear record of each type
+		uint32_t	clr_seq[jr_clear];						// The sequence numbers of the last clear record of each type
+};
+
+#endif
@@ -133,6 +133,11 @@ void Error_Handler(void);
 /* USER CODE BEGIN Private defines */
 #define FW_VERSION	("1.12")
 //#define DEBUG_ON
+//#define ADC_OVERSAMPLE	(4)								// Number of the iron and gun temperature samples per TIM5 phase (2-8), see core.cpp
+//#define ISR_PROFILE										// Measure the control path IRQ handlers duration by DWT cycle counter, see isrprof.h
+//#define ISR_TELEMETRY									// Pass the control path samples from ADC IRQ handler to the main loop, see telemetry.h
+//#define IRON_FEED_FORWARD								// Add the learned tip thermal model power to the IRON PID output, see tmodel.h
+//#define UI_RETAINED		(48)							// The number of the screen nodes of the retained scene, repaint the changed widgets only on mode switch, see scene.h
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
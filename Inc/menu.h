@@ -16,6 +16,8 @@
  *  	Added 'safe_iron_mode' boolean parameter into MSETUP
  *  2025 NOV 03, v.1.12
  *  	Added MENU_GUN::MG_FAN_VOLTAGE menu item to support Hot Air Gun with 12v fan
+ *  2026 OCT 16, v.1.13
+ *  	Added MENU_GUN::MG_MODULATION menu item to select the Hot Air Gun power modulator
  */
 
 #ifndef MENU_H_
@@ -141,6 +143,7 @@ class MENU_GUN : public MODE {
 		MODE*		mode_calibrate;
 		bool		fast_gun_chill	= false;				// Start chilling the Hot Gun at a maximum fan speed
 		bool		is_fan_24v		= false;
+		bool		sigma_delta		= false;				// Use sigma-delta power modulator instead of power patterns
 		uint8_t		stby_timeout	= 0;					// Automatic switch off timeout in minutes or 0 to disable
 		uint16_t	stby_temp		= 0;					// The low power temperature (Celsius) 0 - switch off the JBC IRON immediately
 		int8_t		set_param		= -1;					// The index of the modifying parameter
@@ -149,7 +152,7 @@ class MENU_GUN : public MODE {
 		const uint8_t	in_place_start	= MG_STBY_TO;		// See the menu names. Index of the first parameter that can be changed inside menu (see nls.h)
 		const uint8_t	in_place_end	= MG_FAN_VOLTAGE;	// See the menu names. Index of the last parameter that can be changed inside menu
 		const uint16_t	min_standby_C	= 120;				// Minimum standby temperature, Celsius
-		enum { MG_FAST_CHILL = 0, MG_STBY_TO, MG_STANDBY_TEMP, MG_FAN_VOLTAGE, MG_SAVE, MG_CALIBRATE, MG_BACK };
+		enum { MG_FAST_CHILL = 0, MG_STBY_TO, MG_STANDBY_TEMP, MG_FAN_VOLTAGE, MG_MODULATION, MG_SAVE, MG_CALIBRATE, MG_BACK };
 };
 
 //---------------------- PID setup menu ------------------------------------------
@@ -26,6 +26,8 @@
  * 		Implemented different maximum manual power for Hakko T12 and JBC irons in MCALIB class
  * 		Added MCALIB::ref_ready_to, MCALIB::max_pwr_t12 and MCALIB::max_pwr_jbc constants
  * 		Added MDEBUG::fan_is_on parameter to manually manage the Hot Air Gun fan
+ * 2026 OCT 16, v.1.13
+ * 		MDEBUG shows worst-case cycles of the control path IRQ handlers if ISR_PROFILE macro defined
  *
  */
 
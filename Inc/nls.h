@@ -17,6 +17,8 @@
  * 		Added "max temperature" preference menu item
  * 	2025 NOV 03, v.1.12
  * 		Added new item value in Hot Air Gun menu for Hot Air Gun with 12v fan.
+ * 	2026 OCT 16, v.1.13
+ * 		Added "power mode" to the Hot Air Gun menu
  */
 
 #ifndef MSG_NLS_H_
@@ -25,8 +27,8 @@
 #include <string>
 
 typedef enum e_msg { MSG_MENU_MAIN, MSG_MENU_SETUP = 10, MSG_MENU_T12 = 10+14, MSG_MENU_JBC = 10+14+11, MSG_MENU_GUN = 10+14+11+6,
-					 MSG_MENU_CALIB = 10+14+11+6+8, MSG_PID_MENU = 10+14+11+6+8+5, MSG_FLASH_MENU = 10+14+11+6+8+5+5,
-					MSG_ON = 10+14+11+6+8+5+5+5, MSG_OFF, MSG_FAN, MSG_PWR,
+					 MSG_MENU_CALIB = 10+14+11+6+9, MSG_PID_MENU = 10+14+11+6+9+5, MSG_FLASH_MENU = 10+14+11+6+9+5+5,
+					MSG_ON = 10+14+11+6+9+5+5+5, MSG_OFF, MSG_FAN, MSG_PWR,
 					MSG_REF_POINT, MSG_REED, MSG_TILT, MSG_DEG, MSG_MINUTES, MSG_SECONDS,
 					MSG_CW, MSG_CCW, MSG_SET, MSG_ERROR, MSG_TUNE_PID, MSG_SELECT_TIP,
 					MSG_EEPROM_READ, MSG_EEPROM_WRITE, MSG_EEPROM_DIRECTORY, MSG_FORMAT_EEPROM, MSG_FORMAT_FAILED,
@@ -106,6 +108,7 @@ class NLS_MSG {
 				{"standby time",	std::string()},
 				{"standby temp.",	std::string()},
 				{"fan voltage",		std::string()},
+				{"power mode",		std::string()},
 				{"save",			std::string()},
 				{"calibrate gun",	std::string()},
 				{"back to menu",	std::string()},
@@ -1,6 +1,9 @@
 /*
  * nls_cfg.h
  *
+ *  2026 OCT 16, v.1.13
+ *  	The font is referenced in place if the flash is memory mapped (QSPI) and the font file is not fragmented
+ *  	Added NLS::isFontMapped(), NLS::reloadLanguageData() and NLS::mappedFont()
  */
 
 #ifndef NLS_CFG_H_
@@ -21,8 +24,10 @@ class NLS {
 		uint8_t			numLanguages(void)					{ return lang_cfg.listSize();	}
 		uint8_t			languageIndex(void)					{ return language_index;		}
 		uint8_t*		font(void)							{ return font_data;				}
+		bool			isFontMapped(void)					{ return font_mapped;			}
 		void			loadLanguageData(const char *language);
 		void			loadLanguageData(uint8_t index);
+		void			reloadLanguageData(void);			// The language files have been changed, load the current language again
 		void			defaultNLS();
 		std::string		languageName(uint8_t index);
 	private:
@@ -31,12 +36,14 @@ class NLS {
 		std::string		fontFile(uint8_t index);
 		bool			loadFont(uint8_t indx);
 		bool			loadMessages(uint8_t indx);
+		uint8_t*		mappedFont(uint32_t size);			// The font data in the memory mapped flash or zero
 		FATFS			flashfs;
 		FIL				cfg_f;
 		JSON_LANG_CFG	lang_cfg;
 		JSON_MESSAGES	msg_parser;
 		uint8_t			language_index	= 0;				// Current language index
-		uint8_t			*font_data		= 0;				// Loaded font data, memory allocated by malloc()
+		uint8_t			*font_data		= 0;				// Loaded font data, memory allocated by malloc() or the memory mapped flash
+		bool			font_mapped		= false;			// The font data is referenced in the memory mapped flash
 		const TCHAR*	fn_cfg			= nsl_cfg;			// vars.h
 };
 
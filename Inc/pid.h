@@ -10,6 +10,10 @@
  *  Introduced the heating-up PID parameters: Kp_force and Ki_force
  *  Added use_force parameter, changed the PID::init() method to initialize the use_force parameter
  *  Both irons are using the force heat-up PID parameters, the Hot Air Gun is not!
+ * 2026 OCT 16, v1.13
+ *  The coefficient denominator power is a template parameter of PID::init() and PID::reqPower()
+ *  The regular and heat-up PID coefficients are stored in the tPIDcoeff array, the set is selected by index
+ *  The PID output is limited by the output range, the integral term is not accumulated while the output is saturated
  */
 
 #ifndef _PID_H
@@ -19,6 +23,13 @@
 #include "stat.h"
 #include "vars.h"
 
+// The PID coefficients multiplied by denominator
+typedef struct s_pid_coeff {
+	int32_t		Kp;
+	int32_t		Ki;
+	int32_t		Kd;
+} tPIDcoeff;
+
 class PIDparam {
 	public:
 		PIDparam(int32_t Kp = 0, int32_t Ki = 0, int32_t Kd = 0);
@@ -36,15 +47,23 @@ class PIDparam {
  *  With the first step:
  *  U0 = Kp*(Xs - X0) + Ki*(Xs - X0); Xn-1 = Xn;
  *  
+ *  The coefficients and the power are stored multiplied by denominator 2^Q. The Q is a template parameter, so the compiler
+ *  replaces the denominator by constant shifts. When the temperature is far lower than the preset one, the heat-up coefficient set
+ *  is used (its Kd is zero). The output is limited by [0; max power], the integral term is not accumulated while the output
+ *  is saturated to prevent the integral windup. The accumulator itself is not clamped: the clamped accumulator loses the
+ *  proportional term reference, so the heat-up stalls far below the preset temperature.
+ *
  *  The default values of PID coefficients can be found in config.cpp
  */
 class PID {
 	public:
 		PID(void) 											{ }
 		void		load(const PIDparam &p);
-		PIDparam	dump(void)								{ return PIDparam(Kp, Ki, Kd);	}
-		void		init(uint16_t ms, uint8_t denominator_p = 11, bool heat_force = true);
+		PIDparam	dump(void)								{ return PIDparam(k[0].Kp, k[0].Ki, k[0].Kd);	}
+		template <uint8_t Q>
+		void		init(uint16_t ms, int32_t max_power, bool heat_force = true);
 		void 		resetPID(uint16_t t = 0);        					// reset PID algorithm history parameters
+		template <uint8_t Q>
 		int32_t 	reqPower(int16_t temp_set, int16_t temp_curr);
 		int32_t  	changePID(uint8_t p, int32_t k);    	// set or get (if parameter < 0) PID parameter
 		void		newPIDparams(uint16_t delta_power, uint32_t diff, uint32_t period);
@@ -55,15 +74,42 @@ class PID {
 		int16_t   	temp_h0			= 0;					// previously measured temperatures
 		int16_t	  	temp_h1			= 0;
 		int32_t  	power			= 0;					// The power iterative multiplied by denominator
-		int32_t  	Kp 				= 10;					// The PID coefficients multiplied by denominator.
-		int32_t     Ki 				= 10;
-		int32_t		Kd				= 0;
-		int32_t		Kp_force		= 10;
-		int32_t		Ki_force		= 5;
+		int32_t		power_max		= 0x7FFFFFFF;			// The maximum power multiplied by denominator
+		tPIDcoeff	k[2] = { {10, 10, 0}, {10, 5, 0} };		// The regular [0] and heat-up [1] PID coefficients
 		int16_t  	denominator_p	= 11;              		// The common coefficient denominator power of 2 (11 means 2048)
 		bool		use_force		= true;					// Flag indicating to use forcibly heating mode
 };
 
+template <uint8_t Q>
+void PID::init(uint16_t ms, int32_t max_power, bool heat_force) { // PID parameters are initialized from EEPROM by load() call
+	k[0]		= { 10, 10, 0 };
+	k[1]		= { 10, 5,  0 };
+	T			= ms;
+	denominator_p = Q;
+	power_max	= max_power << Q;
+	use_force	= heat_force;
+}
+
+// Called from the IRQ handlers. Power is stored multiplied by denominator!
+template <uint8_t Q>
+int32_t PID::reqPower(int16_t temp_set, int16_t temp_curr) {
+	const tPIDcoeff &c = k[use_force && temp_curr + 100 < temp_set];	// Aggressive heat-up mode far from the preset temperature
+	int32_t err = temp_set - temp_curr;
+	if (temp_h0 == 0) {										// Use direct formulae because do not know previous temperature
+		power  = (c.Kp + c.Ki) * err;
+	} else {
+		power += c.Kp * (temp_h1 - temp_curr) + c.Kd * (temp_h0 + temp_curr - 2 * temp_h1);
+		if ((power < power_max || err < 0) && (power > 0 || err > 0))	// Anti-windup: do not integrate while the output is saturated
+			power += c.Ki * err;
+	}
+	temp_h0 = temp_h1;
+	temp_h1 = temp_curr;
+	int32_t p = power;
+	if (p < 0)			p = 0;								// Limit the output by [0; max power]
+	if (p > power_max)	p = power_max;
+	return (p + (1 << (Q-1))) >> Q;							// Divide by the denominator, round the result
+}
+
 class PIDTUNE {
 	public:
 		PIDTUNE(void) : period(auto_pid_hist_length), temp_max(auto_pid_hist_length), temp_min(auto_pid_hist_length)		{ 	}
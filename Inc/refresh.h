@@ -0,0 +1,61 @@
+/*
+ * refresh.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The refresh governor of the main working mode dashboard. The status widgets (temperature, power, gauges) are redrawn
+ *  with the period depending on how fast the shown values are changing:
+ *  - fast_period while the temperature of the unit changes fast (heat-up, cool-down) or during hold_time after the user action (encoder rotated or pressed);
+ *  - normal_period while the temperature changes slowly or the temperature dispersion is higher than stable_disp;
+ *  - slow_period when the temperature of every unit shown is stable, so the SPI bus and the CPU time are free for the control and the UI.
+ *
+ *  The mode logic calls watch() for every unit shown each logic step (500 ms) and frame() in the main loop; frame() returns true
+ *  when the dashboard should be redrawn. The period is re-evaluated on every call, so the rate rises as soon as the value starts changing.
+ *
+ *  The governor measures the frames per second and the SPI bus utilization of the display (the bytes sent relative to the bus bit rate,
+ *  see TFT_SPI_BusBytes()) during the statistic window of about one second. The FSMC display bus is not measured, its load is shown as zero.
+ *  Only the dashboard frames are counted: start() begins new window
+ *  when the working mode is activated, and fps() and busLoad() keep the figures of the last complete dashboard window, so the debug mode can show them.
+ */
+
+#ifndef REFRESH_H_
+#define REFRESH_H_
+
+#include "main.h"
+
+#define RFR_UNITS		(2)									// The number of units shown on the dashboard
+
+typedef enum { RFR_STABLE = 0, RFR_NORMAL, RFR_FAST } tRfrRate;
+
+class REFRESH {
+	public:
+		REFRESH(void)										{ }
+		void		start(void);							// The dashboard is activated, start new statistic window
+		void		activity(void);							// The user action: redraw now and keep the fast rate for hold_time
+		void		watch(uint8_t unit, uint16_t temp, uint16_t disp);	// Check the unit temperature (internal units) and its dispersion
+		bool		frame(void);							// True if the dashboard should be redrawn now
+		uint16_t	period(void);							// Current redraw period, ms
+		uint16_t	fps(void)								{ return s_fps;									}
+		uint8_t		busLoad(void)							{ return s_bus;									}
+	private:
+		void		count(void);							// The frame has been drawn, update the statistics
+		tRfrRate	rate[RFR_UNITS]	= {RFR_NORMAL, RFR_NORMAL};
+		uint16_t	last_temp[RFR_UNITS] = {0, 0};
+		uint32_t	fast_until		= 0;					// The time to keep the fast rate after the user action, ms
+		uint32_t	last_frame		= 0;					// The time when the last frame was drawn, ms
+		bool		force			= true;					// Redraw the dashboard immediately
+		uint32_t	frames			= 0;					// The number of frames drawn in the statistic window
+		uint32_t	win_start		= 0;					// The statistic window start time, ms
+		uint32_t	win_bytes		= 0;					// The bus byte counter at the window start
+		uint16_t	s_fps			= 0;					// The frames per second of the last window multiplied by 10
+		uint8_t		s_bus			= 0;					// The SPI bus utilization of the last window, %
+		const uint16_t	fast_period		= 100;				// The redraw periods, ms
+		const uint16_t	normal_period	= 500;
+		const uint16_t	slow_period		= 2000;
+		const uint16_t	hold_time		= 2000;				// The time to keep the fast rate after the user action, ms
+		const uint16_t	fast_delta		= 40;				// The temperature change per logic step to switch to the fast rate (internal units)
+		const uint16_t	stable_delta	= 4;				// The maximum temperature change per logic step of the stable unit (internal units)
+		const uint16_t	stable_disp		= 500;				// The maximum temperature dispersion of the stable unit
+};
+
+#endif
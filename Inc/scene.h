@@ -0,0 +1,92 @@
+/*
+ * scene.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The retained scene of the display. Every drawing of the DSPL class (the bitmap, icon, filled rectangle, line, text or the widget
+ *  that draws itself, see tSceneKind) is registered as a node: its screen area and the signature of its content (the hash of the bitmap and colors).
+ *  So the scene knows what is shown on the screen now.
+ *
+ *  DSPL::clear() does not clear the screen but starts the new frame: all nodes become stale. When the new mode draws the node
+ *  with the same area and signature and nothing has been drawn over this node since it was drawn, the drawing is skipped.
+ *  Otherwise the node is drawn and the nodes under it are marked as overdrawn. commit() closes the frame:
+ *  the stale nodes that have not been drawn again are erased except the areas of the nodes drawn in the current frame.
+ *  The text is transparent, so it is never skipped and the stale content under the text is erased before the text is drawn.
+ *
+ *  The node coordinates are the coordinates of the current screen rotation, DSPL::rotate() drops the scene (see lose()),
+ *  so the next frame clears the whole screen and the layout of the new rotation is built from scratch.
+ *  When there is no free node, the least recently used stale node is dropped and erased immediately. If there is no stale node,
+ *  the frame is closed and the area of the dropped current node is kept in the residue area, that will be erased by the next frame.
+ *
+ *  The scene is enabled by UI_RETAINED macro, see main.h. If the macro is not defined, every drawing is performed
+ *  and DSPL::clear() clears the whole screen.
+ */
+
+#ifndef SCENE_H_
+#define SCENE_H_
+
+#include "main.h"
+
+typedef enum { sc_fill = 0, sc_bitmap, sc_icon, sc_text, sc_widget } tSceneKind;
+
+class SCENE {
+	public:
+		SCENE(void)											{ }
+		virtual		~SCENE(void)							{ }
+		static uint32_t	hash(const void *data, uint32_t size, uint32_t h = 2166136261U);	// FNV-1a
+#ifdef UI_RETAINED
+		bool		begin(void);							// Start new frame, false if the screen should be cleared
+		bool		paint(tSceneKind kind, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t sig, bool opaque = true);
+		void		commit(void);							// Erase the stale nodes, close the frame
+		void		reset(void);							// The screen has been cleared
+		void		lose(void)								{ valid = false;								}
+		uint32_t	paintedPixels(void)						{ return painted;								}
+		uint32_t	keptPixels(void)						{ return kept;									}
+		uint32_t	erasedPixels(void)						{ return erased;								}
+		void		resetStat(void)							{ painted = kept = erased = 0;					}
+	protected:
+		virtual void eraseArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height)	= 0;
+	private:
+		typedef struct s_node {
+			int16_t		x, y;
+			uint16_t	w, h;
+			uint32_t	sig;								// The content signature
+			uint32_t	used;								// The last usage counter, to drop least recently used node
+			bool		clean;								// Nothing has been drawn over the node
+			bool		stale;								// The node belongs to the previous frame
+		} tNode;
+		typedef struct s_area {
+			int16_t		x0, y0, x1, y1;						// x1 and y1 are exclusive, empty if x0 >= x1
+		} tArea;
+		void		erase(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t first = 0);
+		void		eraseStale(int16_t x, int16_t y, uint16_t w, uint16_t h);
+		uint8_t		newNode(void);
+		void		removeNode(uint8_t i);
+		static bool	overlap(const tNode &n, int32_t x, int32_t y, int32_t w, int32_t h)
+															{ return x < n.x + n.w && n.x < x + w && y < n.y + n.h && n.y < y + h; }
+		static void	merge(tArea &a, int16_t x, int16_t y, uint16_t w, uint16_t h);
+		tNode		node[UI_RETAINED];
+		uint8_t		nodes		= 0;						// The number of nodes in use
+		tArea		residue		= {0, 0, 0, 0};				// The area of dropped nodes of the current frame
+		tArea		res_stale	= {0, 0, 0, 0};				// The area of dropped nodes of the previous frame
+		uint32_t	use_cnt		= 0;
+		bool		valid		= false;					// The scene matches the screen
+		bool		frame		= false;					// The frame is open, there are stale nodes
+		uint32_t	painted		= 0;						// The number of pixels drawn
+		uint32_t	kept		= 0;						// The number of pixels skipped because they are already on the screen
+		uint32_t	erased		= 0;						// The number of stale pixels erased
+#else
+		bool		begin(void)								{ return false;									}
+		bool		paint(tSceneKind kind, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t sig, bool opaque = true)
+															{ return true;									}
+		void		commit(void)							{ }
+		void		reset(void)								{ }
+		void		lose(void)								{ }
+		uint32_t	paintedPixels(void)						{ return 0;										}
+		uint32_t	keptPixels(void)						{ return 0;										}
+		uint32_t	erasedPixels(void)						{ return 0;										}
+		void		resetStat(void)							{ }
+#endif
+};
+
+#endif
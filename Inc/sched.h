@@ -0,0 +1,42 @@
+/*
+ * sched.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  Cooperative scheduler of the main loop periodic tasks.
+ *  The tasks are kept in the list ordered by the deadline, so SCHED::run() checks the first task only.
+ *  When no task is ready, SCHED::run() puts the CPU to sleep (__WFI) till the next interrupt. SysTick wakes the CPU up every 1 ms.
+ *  The task deadline is advanced by its period, so the task keeps its cadence. If the task is late more than one period,
+ *  the missed activations are skipped. The maximum task activation delay is kept till resetStat() to be shown in the debug mode.
+ */
+
+#ifndef SCHED_H_
+#define SCHED_H_
+
+#include "main.h"
+
+#define SCHED_MAX_TASKS	(8)
+
+typedef void (*tTaskFunc)(void);
+
+class SCHED {
+	public:
+		SCHED(void)											{ }
+		int8_t		add(tTaskFunc func, uint32_t period, uint32_t delay = 0);	// Return task ID or -1 if no room
+		void		run(void);								// Run ready tasks in the deadline order, sleep if no task is ready
+		uint32_t	maxLateness(void)						{ return max_late;								}
+		void		resetStat(void)							{ max_late = 0;									}
+	private:
+		void		reorder(uint8_t pos);					// Move the task at pos to keep the list ordered by deadline
+		typedef struct s_task {
+			tTaskFunc	func;
+			uint32_t	period;								// The task activation period, ms
+			uint32_t	deadline;							// The time when the task should be activated, ms
+		} tTask;
+		tTask		task[SCHED_MAX_TASKS];
+		uint8_t		order[SCHED_MAX_TASKS];					// Task indexes ordered by deadline
+		uint8_t		len			= 0;						// The number of registered tasks
+		uint32_t	max_late	= 0;						// Maximum task activation delay, ms
+};
+
+#endif
@@ -7,6 +7,9 @@
  * Sep 05 2023
  *    Changed the argument type in haveToUpdate() from std::string to const char *
  *    Changed the argument type in copyFile() from std::string to const char *
+ * Oct 16 2026
+ *    Added the bigger copy buffer sizes, so the SD-CARD data is read by the multiple blocks
+ *    Added the language files manifest (sync.dat) and SDLOAD::syncFile() to copy the changed language files only
  *
  */
 
@@ -21,6 +24,20 @@
 
 extern SDCARD sd;
 
+typedef enum { SYNC_DONE = 0, SYNC_COPY } tSyncState;
+
+/*
+ * The language file manifest entry. The manifest file on the SPI FLASH keeps an entry for every language file copied from the SD-CARD
+ */
+typedef struct s_sync_entry {
+	char		name[32];									// The file name
+	uint32_t	size;										// The source file size
+	uint32_t	time;										// The source file timestamp: date << 16 | time
+	uint32_t	crc;										// CRC-32 of the source file data
+	uint32_t	state;										// tSyncState: the file is copied or is being copied into the temporary file
+	uint32_t	rec_crc;									// CRC-32 of the previous fields
+} t_sync_entry;
+
 class SDLOAD {
 	public:
 		SDLOAD(void)										{ }
@@ -36,6 +53,10 @@ class SDLOAD {
 		bool		isLanguageDataConsistent(t_lang_cfg &lang_data);
 		bool		haveToUpdate(const char *name);
 		bool		copyFile(const char *name, bool load = true);
+		bool		syncFile(const char *name);				// Copy the language file from SD-CARD if it has been changed
+		bool		fileCRC(const char *path, uint32_t &crc);
+		int16_t		findEntry(const char *name, t_sync_entry &e);	// Return the manifest entry index or -1
+		int16_t		saveEntry(t_sync_entry &e, int16_t index);		// Save the entry at the index (append if -1), return the entry index
 		uint8_t			*buffer		= 0;					// The buffer to copy the file, allocated later
 		uint16_t		buffer_size	= 0;					// The allocated buffer size
 		FATFS			sdfs, flashfs;
@@ -43,7 +64,8 @@ class SDLOAD {
 		JSON_LANG_CFG	lang_cfg;
 		t_lang_list		*lang_list = 0;
 		const TCHAR*	fn_cfg			= nsl_cfg;			// vars.h
-		const uint16_t	b_sizes[3] = { 4096, 1024, 512};	// Possible copy buffer sizes
+		const TCHAR*	fn_manifest		= "0:sync.dat";		// The language files manifest on the SPI FLASH
+		const uint16_t	b_sizes[5] = { 16384, 8192, 4096, 1024, 512};	// Possible copy buffer sizes
 };
 
 #endif
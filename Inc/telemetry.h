@@ -0,0 +1,113 @@
+/*
+ * telemetry.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The control path telemetry. Every temperature check phase in HAL_ADC_ConvCpltCallback() (see core.cpp) writes a compact sample
+ *  record (raw ADC value, computed power, phase and sequence number) into the single-producer/single-consumer lock-free ring buffer.
+ *  The main loop drains the ring buffer by the scheduler task, so every sample can be used without disabling the interrupts.
+ *  The main loop keeps the statistics of every phase during the last second: the number of samples, the average and maximum power
+ *  and the temperature ripple (the raw ADC value swing), which the averaged unit temperature hides.
+ *  The sample time is not recorded: the samples are taken by TIM5 with the constant period and the statistics are per second.
+ *
+ *  The ADC IRQ handler is the only producer: it writes the record first and then moves the head index.
+ *  The main loop is the only consumer: it reads the record first and then moves the tail index.
+ *  Each index is changed by one side only, the 32-bit aligned access is atomic on Cortex-M4, so no lock is required.
+ *  When the ring is full, the new sample is dropped. The producer increments the sequence number anyway, so the consumer
+ *  counts the dropped samples by the gaps in the sequence; the producer does not keep any statistics.
+ *
+ *  The telemetry is enabled by ISR_TELEMETRY macro, see main.h.
+ *  If the macro is not defined, all methods are empty and the compiler removes the telemetry code completely.
+ *  The classes are visible to C++ only, C modules (main.c includes core.h) see the phase enumeration only.
+ */
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include "main.h"
+
+#define TLM_SIZE		(64)								// The ring buffer size, should be a power of 2
+
+typedef enum { TLM_T12 = 0, TLM_JBC, TLM_GUN, TLM_LAST } tTlmPhase;
+
+typedef struct s_tlm_sample {
+	uint16_t	raw;										// The raw ADC value (temperature in internal units)
+	uint16_t	power;										// The power calculated by the unit
+	uint16_t	seq;										// The sample sequence number
+	uint8_t		phase;										// tTlmPhase
+} tTlmSample;
+
+#ifdef __cplusplus
+class TLMRING {
+	public:
+		TLMRING(void)										{ }
+		bool		push(const tTlmSample &s);				// Producer side (IRQ handler)
+		bool		pop(tTlmSample &s);						// Consumer side (main loop)
+		uint16_t	available(void)							{ return (head - tail) & (TLM_SIZE-1);			}
+	private:
+		tTlmSample			buff[TLM_SIZE];
+		volatile uint32_t	head	= 0;					// The next record to be written, changed by producer only
+		volatile uint32_t	tail	= 0;					// The next record to be read, changed by consumer only
+};
+
+inline bool TLMRING::push(const tTlmSample &s) {
+	uint32_t h		= head;
+	uint32_t next	= (h + 1) & (TLM_SIZE-1);
+	if (next == tail)										// The ring buffer is full
+		return false;
+	buff[h] = s;
+	__DMB();												// The record should be written before the head index is moved
+	head = next;
+	return true;
+}
+
+inline bool TLMRING::pop(tTlmSample &s) {
+	uint32_t t = tail;
+	if (t == head) return false;							// The ring buffer is empty
+	__DMB();												// Read the record after the head index
+	s = buff[t];
+	__DMB();												// The record should be read before the tail index is moved
+	tail = (t + 1) & (TLM_SIZE-1);
+	return true;
+}
+
+class TELEMETRY {
+	public:
+		TELEMETRY(void)										{ }
+#ifdef ISR_TELEMETRY
+		void		put(tTlmPhase phase, uint16_t raw, uint16_t power);	// Called from the IRQ handler
+		void		drain(void);							// Called from the main loop, updates the statistics
+		uint16_t	rate(tTlmPhase phase)					{ return (phase < TLM_LAST)?s_rate[phase]:0;	} // samples per second
+		uint16_t	avgPower(tTlmPhase phase)				{ return (phase < TLM_LAST)?s_avg[phase]:0;		} // during last second
+		uint16_t	maxPower(tTlmPhase phase)				{ return (phase < TLM_LAST)?s_max[phase]:0;		} // during last second
+		uint16_t	ripple(tTlmPhase phase)					{ return (phase < TLM_LAST)?s_ripple[phase]:0;	} // raw ADC swing during last second
+		uint32_t	dropped(void)							{ return lost;									}
+	private:
+		TLMRING		ring;
+		uint16_t	seq					= 0;				// The sequence number of the next sample, changed by producer only
+		uint16_t	next_seq			= 0;				// The expected sequence number of the next sample read, changed by consumer only
+		uint32_t	lost				= 0;				// The number of dropped samples, found by the sequence gaps
+		uint32_t	period_end			= 0;				// The end of current statistics period, ms
+		uint16_t	cnt[TLM_LAST]		= {0};				// The number of samples during current second
+		uint32_t	p_sum[TLM_LAST]		= {0};				// The total power during current second
+		uint16_t	p_max[TLM_LAST]		= {0};				// The maximum power during current second
+		uint16_t	r_min[TLM_LAST]		= {0};				// The minimum raw ADC value during current second
+		uint16_t	r_max[TLM_LAST]		= {0};				// The maximum raw ADC value during current second
+		uint16_t	s_rate[TLM_LAST]	= {0};				// The number of samples during previous second
+		uint16_t	s_avg[TLM_LAST]		= {0};				// The average power during previous second
+		uint16_t	s_max[TLM_LAST]		= {0};				// The maximum power during previous second
+		uint16_t	s_ripple[TLM_LAST]	= {0};				// The raw ADC value swing during previous second
+#else
+		void		put(tTlmPhase phase, uint16_t raw, uint16_t power)	{ }
+		void		drain(void)								{ }
+		uint16_t	rate(tTlmPhase phase)					{ return 0;										}
+		uint16_t	avgPower(tTlmPhase phase)				{ return 0;										}
+		uint16_t	maxPower(tTlmPhase phase)				{ return 0;										}
+		uint16_t	ripple(tTlmPhase phase)					{ return 0;										}
+		uint32_t	dropped(void)							{ return 0;										}
+#endif
+};
+
+#endif
+
+#endif
@@ -0,0 +1,50 @@
+/*
+ * tmodel.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The learned first-order thermal model of the IRON tip: C * dT = P - L * T
+ *  T is the tip temperature in internal units. The thermocouple reading is proportional to the difference between the tip and ambient temperatures.
+ *  P is the applied power, L is the heat loss coefficient and C is the heat capacity of the tip. The time unit is the IRON::power() call period.
+ *  The loss coefficient is learned when the temperature is stable: L = P / T
+ *  The heat capacity is learned when the IRON is heating up: C = (P - L * T) / dT
+ *  Both coefficients are exponentially averaged and kept as fixed-point values: the loss in Q8 and the capacity in Q4 format.
+ *  The zero coefficient means it was not learned yet.
+ *
+ *  The feed-forward power is a part of the steady-state power to keep the preset temperature plus the power to compensate
+ *  the temperature drop, for instance when the tip touches the large ground plane. The PID compensates the rest.
+ */
+
+#ifndef TMODEL_H_
+#define TMODEL_H_
+
+#include "main.h"
+#include "stat.h"
+
+class TMODEL {
+	public:
+		TMODEL(void)										{ }
+		void		init(uint16_t capacity, uint16_t loss);
+		void		step(int32_t t, int32_t p)				{ t_prev = t; p_prev = p;						}
+		void		learnStable(int32_t avg_power, int32_t avg_temp);
+		void		learnHeating(int32_t t);
+		int32_t		feedForward(int32_t t_set, int32_t t);
+		uint16_t	capacity(void)							{ return cap_ready?h_cap.read():0;				}
+		uint16_t	loss(void)								{ return loss_ready?h_loss.read():0;			}
+		bool		isReady(void)							{ return cap_ready && loss_ready;				}
+	private:
+		EXPA		h_cap;									// Exponential average of heat capacity, Q4
+		EXPA		h_loss;									// Exponential average of heat loss coefficient, Q8
+		bool		cap_ready		= false;				// The heat capacity has been learned or loaded
+		bool		loss_ready		= false;				// The heat loss coefficient has been learned or loaded
+		int32_t		t_prev			= 0;					// The temperature at previous step
+		int32_t		p_prev			= 0;					// The power applied at previous step
+		static const uint8_t	cap_len		= 16;			// Heat capacity averaging length
+		static const uint8_t	loss_len	= 128;			// Heat loss averaging length, the stable temperature is checked very often
+		static const int32_t	min_temp	= 100;			// Minimal temperature (internal units) to learn heat loss
+		static const int32_t	min_rise	= 4;			// Minimal temperature rise per step to learn heat capacity
+		static const int32_t	min_drop	= 2;			// Minimal temperature drop per step to apply compensation power
+		static const uint8_t	ss_share	= 3;			// The steady-state feed-forward power share (n/4), the PID integral cannot be negative
+};
+
+#endif
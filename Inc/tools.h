@@ -6,6 +6,9 @@
  *
  * Sep 09 2023, v 1.03
  *  	Added emap()
+ * Oct 16 2026, v 1.13
+ *  	Added isqrt()
+ *  	Added crc32()
  */
 
 #ifndef TOOLS_H_
@@ -25,6 +28,8 @@ int32_t		emap(int32_t value, int32_t v_min, int32_t v_max, int32_t r_min, int32_
 int32_t 	map(int32_t value, int32_t v_min, int32_t v_max, int32_t r_min, int32_t r_max);
 int32_t		constrain(int32_t value, int32_t min, int32_t max);
 uint8_t 	gauge(uint8_t percent, uint8_t p_middle, uint8_t g_max);
+uint32_t	isqrt(uint64_t value);
+uint32_t	crc32(const void *data, uint32_t size, uint32_t crc);
 
 int16_t 	celsiusToFahrenheit(int16_t cels);
 int16_t		fahrenheitToCelsius(int16_t fahr);
@@ -5,6 +5,9 @@
  *
  * 2025 SEP 17, v.1.10
  * 		Added MWORK::save_preset_to and MWORK::enc_changed_ms allowing to save the preset temperatures after the encoder rotated
+ * 2026 OCT 16, v.1.13
+ * 		Added MWORK::clean() and MWORK::saveTipModels() to save the learned tip thermal models
+ * 		MWORK::period is the logic step period, the status redraw period is defined by the refresh governor (see refresh.h)
  */
 
 #ifndef _WORK_MODE_H_
@@ -21,7 +24,9 @@ class MWORK : public DASH {
 		MWORK(HW *pCore) : DASH(pCore), idle_pwr(5)		{ }
 		virtual void	init(void);
 		virtual MODE*	loop(void);
+		virtual void	clean(void)							{ saveTipModels();								}
 	private:
+		void			saveTipModels(void);				// Save the learned IRON tip thermal models to the FLASH
 		void			selectUpperUnit(tDevice dev);
 		void			manageHardwareSwitches(CFG* pCFG, IRON *pT12, IRON *pJBC, HOTGUN *pHG); // True if exit from the mode
 		void 			adjustPresetTemp(void);
@@ -52,7 +57,7 @@ class MWORK : public DASH {
 		bool			edit_temp		= true;				// The HOT AIR GUN Encoder mode (Edit Temp/Edit fan)
 		uint32_t		return_to_temp	= 0;				// Time when to return to temperature edit mode (ms)
 		bool			start			= true;				// Flag indicating the controller just started (used to turn the IRON on)
-		const uint16_t	period			= 500;				// Redraw display period (ms)
+		const uint16_t	period			= 500;				// The logic step period (ms)
 		const uint16_t	tilt_show_time	= 1500;				// Time the tilt icon to be shown
 		const uint32_t	check_jbc_to	= 500;				// When start checking the current through the JBC
 		const uint16_t	edit_fan_timeout = 3000;			// The time to edit fan speed (ms)
@@ -1,5 +1,11 @@
 /* vim: set ai et ts=4 sw=4: */
 
+/*
+ * The data blocks are transferred by the single SPI transaction (or by DMA if SD_SPI_DMA defined), not byte by byte.
+ * The multiple blocks are read by CMD18 and written by CMD25 commands, see SD_ReadBlocks() and SD_WriteSBlocks()
+ */
+
+#include <string.h>
 #include "sdspi.h"
 
 #define BLOCK_SIZE_HC	(512)
@@ -37,6 +43,42 @@ static uint8_t SD_ReadBytes(uint8_t* buff, size_t buff_size) {
     return 0;
 }
 
+#ifdef SD_SPI_DMA
+// Wait for the DMA transfer to complete
+static uint8_t SD_WaitDMA(void) {
+	uint32_t start = HAL_GetTick();
+	while (HAL_SPI_GetState(&SD_SPI_PORT) != HAL_SPI_STATE_READY) {
+		if (HAL_GetTick() - start > 1000) {
+			HAL_SPI_Abort(&SD_SPI_PORT);
+			return 1;
+		}
+	}
+	return 0;
+}
+#endif
+
+// Receive the data block. The buffer is filled with 0xFF bytes to be sent while the data being received
+static uint8_t SD_ReceiveBlock(uint8_t *buff, uint16_t size) {
+	memset(buff, 0xFF, size);
+#ifdef SD_SPI_DMA
+	if (HAL_OK != HAL_SPI_TransmitReceive_DMA(&SD_SPI_PORT, buff, buff, size))
+		return 1;
+	return SD_WaitDMA();
+#else
+	return (HAL_OK == HAL_SPI_TransmitReceive(&SD_SPI_PORT, buff, buff, size, HAL_MAX_DELAY))?0:1;
+#endif
+}
+
+static uint8_t SD_SendBlock(const uint8_t *data, uint16_t size) {
+#ifdef SD_SPI_DMA
+	if (HAL_OK != HAL_SPI_Transmit_DMA(&SD_SPI_PORT, (uint8_t *)data, size))
+		return 1;
+	return SD_WaitDMA();
+#else
+	return (HAL_OK == HAL_SPI_Transmit(&SD_SPI_PORT, (uint8_t *)data, size, HAL_MAX_DELAY))?0:1;
+#endif
+}
+
 static uint32_t ext_bits(uint8_t *data, int msb, int lsb) {
     uint32_t bits = 0;
     uint32_t size = 1 + msb - lsb;
@@ -116,7 +158,7 @@ static uint8_t SD_DATA_CMD(SPISD_CMD cmd, uint32_t arg, uint8_t token, uint8_t *
         }
     }
 
-    if (SD_ReadBytes(data, size) != 0) {
+    if (SD_ReceiveBlock(data, size) != 0) {
         SD_Unselect();
         return 3;
     }
@@ -326,7 +368,10 @@ uint8_t SD_WriteSingleBlock(SDCARD *sd, uint32_t block_num, const uint8_t* data)
     uint8_t data_token = 0xFE;								// Data start token
     uint8_t crc[2] = { 0xFF, 0xFF };
     HAL_SPI_Transmit(&SD_SPI_PORT, &data_token, sizeof(data_token), HAL_MAX_DELAY);
-    HAL_SPI_Transmit(&SD_SPI_PORT, (uint8_t*)data, BLOCK_SIZE_HC, HAL_MAX_DELAY);
+    if (SD_SendBlock(data, BLOCK_SIZE_HC) != 0) {
+        SD_Unselect();
+        return 4;
+    }
     HAL_SPI_Transmit(&SD_SPI_PORT, crc, sizeof(crc), HAL_MAX_DELAY);
 
     /*
@@ -386,7 +431,7 @@ uint8_t SD_ReadBlocks(SDCARD *sd, uint32_t start_block, uint8_t count, uint8_t*
 		}
 
 		// Read data packet
-		if (SD_ReadBytes(data+i*BLOCK_SIZE_HC, BLOCK_SIZE_HC) != 0) {
+		if (SD_ReceiveBlock(data+i*BLOCK_SIZE_HC, BLOCK_SIZE_HC) != 0) {
 			SD_Unselect();
 			return 5;
 		}
@@ -436,7 +481,7 @@ uint8_t SD_WriteSBlocks(SDCARD *sd, uint32_t start_block, uint8_t count, const u
 		count = sd->blocks - start_block;
 	}
 	if (sd->type == TYPE_SDSC)
-		count *= BLOCK_SIZE_HC;
+		start_block *= BLOCK_SIZE_HC;						// SDSC card uses byte address
 
 	if (0 != SD_CMD(CMD25_WRITE_MULTIPLE_BLOCK, start_block)) {
 		SD_Unselect();
@@ -449,7 +494,10 @@ uint8_t SD_WriteSBlocks(SDCARD *sd, uint32_t start_block, uint8_t count, const u
 		uint8_t data_token = 0xFC;							// Data start token
 		uint8_t crc[2] = { 0xFF, 0xFF };
 		HAL_SPI_Transmit(&SD_SPI_PORT, &data_token, sizeof(data_token), HAL_MAX_DELAY);
-		HAL_SPI_Transmit(&SD_SPI_PORT, (uint8_t *)data+i*BLOCK_SIZE_HC, BLOCK_SIZE_HC, HAL_MAX_DELAY);
+		if (SD_SendBlock(data+i*BLOCK_SIZE_HC, BLOCK_SIZE_HC) != 0) {
+			SD_Unselect();
+			return 4;
+		}
 		HAL_SPI_Transmit(&SD_SPI_PORT, crc, sizeof(crc), HAL_MAX_DELAY);
 
 		/*
@@ -7,6 +7,9 @@
 #define SD_SPI_PORT      hspi2
 extern SPI_HandleTypeDef SD_SPI_PORT;
 
+// Uncomment the next line to transfer the data blocks by DMA. The SPI2 RX and TX DMA streams should be configured in CubeMX
+//#define SD_SPI_DMA
+
 typedef enum e_sd_type {
 	TYPE_NOT_READY = 0, TYPE_SDSC, TYPE_SDHC
 } SD_TYPE;
@@ -0,0 +1,83 @@
+/*
+ * actrack.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  AC power zero-cross tracker, see actrack.h
+ */
+
+#include "actrack.h"
+#include "tools.h"
+
+void ACTRACK::init(void) {
+	uint32_t tim_clock = HAL_RCC_GetPCLK1Freq();			// The TIM5 is clocked from APB1 bus
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)		// The timer clock is doubled if APB1 prescaler is not 1
+		tim_clock <<= 1;
+	ticks_hz	= tim_clock / (TIM5->PSC + 1);
+	h_half.length(16);
+	h_jitter.length(16);
+	h_half.reset(0);
+	h_jitter.reset(0);
+	half_ready	= false;
+	locked		= false;
+	ms_prev		= 0;
+	corr		= 0;
+	integral	= 0;
+}
+
+uint16_t ACTRACK::halfPeriod(void) {
+	if (!half_ready) return 0;
+	return ((uint64_t)h_half.read() * 100000 / ticks_hz + 8) >> 4;
+}
+
+uint16_t ACTRACK::frequency(void) {
+	uint32_t half = h_half.read();
+	if (!half_ready || half == 0) return 0;
+	return ticks_hz * 800 / half;							// 100 * ticks_hz / (2 * half / 16)
+}
+
+void ACTRACK::zeroCross(uint32_t ms) {
+	uint32_t	cnt		= TIM5->CNT;
+	int32_t		period	= TIM5->ARR + 1;
+	int32_t		half	= period >> 1;
+	if (ms_prev > 0 && ms - ms_prev < max_gap_ms) {			// Previous zero-cross was registered, measure the half-period
+		int32_t delta = (int32_t)cnt - (int32_t)cnt_prev - corr;
+		if (delta <= 0) delta += period;
+		if (delta > (half >> 1) && delta < period) {		// Skip wrong values
+			if (half_ready) {
+				int32_t dev = delta - ((h_half.read() + 8) >> 4);
+				if (dev < 0) dev = -dev;
+				h_jitter.update(dev << 4);
+				h_half.update(delta << 4);
+			} else {
+				h_half.reset(delta << 4);
+				half_ready = true;
+			}
+		}
+	}
+	ms_prev		= ms;
+	cnt_prev	= cnt;
+	corr		= 0;
+
+	// Align TIM5 if two AC half-periods fit the TIM5 period, i.e. 50 Hz AC line
+	int32_t h2 = ((h_half.read() + 8) >> 4) << 1;
+	if (!half_ready || h2 < period - (period >> 6) || h2 > period + (period >> 6)) {
+		locked = false;
+		return;
+	}
+	int32_t err = cnt % half;								// Zero-cross should happen at TIM5 period beginning or in the middle
+	if (err >= (half >> 1)) err -= half;
+	phase_err = err;
+	if ((int32_t)cnt < (half >> 1) || (int32_t)cnt >= period - (half >> 1))
+		return;												// Do not correct TIM5 near the period bounds
+	if (err > coarse_err || err < -coarse_err) {
+		corr		= -err;
+		integral	= 0;
+	} else {
+		integral	= constrain(integral + err, -max_integral, max_integral);
+		corr		= -constrain(err / 4 + integral / 32, -max_step, max_step);
+	}
+	locked = (err <= lock_err && err >= -lock_err);
+	if (corr)
+		TIM5->CNT += corr;
+}
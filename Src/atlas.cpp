@@ -0,0 +1,146 @@
+/*
+ * atlas.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The digit atlas of the numeric readouts, see atlas.h
+ */
+
+#include <string.h>
+#include "atlas.h"
+#include "common.h"
+
+void DIGIT_ATLAS::build(u8gFont &font) {
+	const char *sym	= ATLAS_SYMBOLS;
+	char	s[2]	= {0, 0};
+	uint8_t	cells	= 0;
+	cell_w = 0;
+	for (uint8_t i = 0; i < ATLAS_SYMBOLS_NUM; ++i) {
+		index[i] = -1;
+		if (!font.isGlyph(sym[i])) continue;
+		index[i] = cells++;
+		s[0] = sym[i];
+		uint16_t w = font.getStrWidth(s);
+		if (w > cell_w) cell_w = w;
+	}
+	invalidate();
+	atlas = BITMAP();										// Free the memory first
+	if (cells == 0 || cell_w == 0) return;
+
+	cell_stride	= (cell_w + 7) & ~7;						// Every cell starts on the byte boundary
+	uint16_t h	= font.getMaxCharHeight();
+	atlas		= BITMAP(cells * cell_stride, h);
+	BITMAP	bm(cell_stride, h);
+	if (atlas.width() == 0 || bm.width() == 0) {			// Not enough memory
+		atlas = BITMAP();
+		return;
+	}
+	uint16_t atlas_row	= atlas.width() >> 3;				// Bytes per row
+	uint16_t cell_row	= cell_stride >> 3;
+	for (uint8_t i = 0; i < ATLAS_SYMBOLS_NUM; ++i) {
+		if (index[i] < 0) continue;
+		s[0] = sym[i];
+		bm.clear();
+		font.strToBitmap(bm, s, align_left, (cell_w - font.getStrWidth(s)) >> 1);
+		for (uint16_t r = 0; r < h; ++r)
+			memcpy(&atlas.bitmap()[r * atlas_row + index[i] * cell_row], &bm.bitmap()[r * cell_row], cell_row);
+	}
+}
+
+void DIGIT_ATLAS::draw(uint16_t x, uint16_t y, uint16_t width, const char *str, BM_ALIGN align, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t h = atlas.height();
+	if (h == 0 || width < cell_w) return;
+	int8_t	cell[ATLAS_LEN];
+	uint8_t	len = 0;
+	for (; str[len] && len < ATLAS_LEN; ++len)
+		cell[len] = cellIndex(str[len]);
+	if (len * cell_w > width)
+		len = width / cell_w;
+	uint16_t w		= len * cell_w;
+	uint16_t start	= 0;
+	if (align == align_center) {
+		start = (width - w) >> 1;
+	} else if (align == align_right) {
+		start = width - w;
+	}
+
+	tReadout &r = readout(x, y, width);
+	bool full = !r.valid || r.bg != bg_color || r.fg != fg_color || r.start != start;
+	if (full) {												// Clear the readout area outside of the cells
+		if (start > 0) {
+			TFT_DrawFilledRect(x, y, start, h, bg_color);
+			pushed += start * h;
+		}
+		if (start + w < width) {
+			TFT_DrawFilledRect(x + start + w, y, width - start - w, h, bg_color);
+			pushed += (width - start - w) * h;
+		}
+	}
+	for (uint8_t i = 0; i < len; ++i) {
+		if (!full && i < r.len && r.cell[i] == cell[i]) continue;
+		drawCell(x + start + i * cell_w, y, cell[i], bg_color, fg_color);
+	}
+	if (!full) {											// Clear the cells of the previous longer string
+		for (uint8_t i = len; i < r.len; ++i)
+			drawCell(x + start + i * cell_w, y, -1, bg_color, fg_color);
+	}
+	memcpy(r.cell, cell, len);
+	r.len	= len;
+	r.start	= start;
+	r.bg	= bg_color;
+	r.fg	= fg_color;
+	r.valid	= true;
+	r.used	= ++use_cnt;
+}
+
+void DIGIT_ATLAS::invalidate(void) {
+	for (uint8_t i = 0; i < ATLAS_SLOTS; ++i)
+		slot[i].valid = false;
+}
+
+void DIGIT_ATLAS::invalidate(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	uint16_t h = atlas.height();
+	for (uint8_t i = 0; i < ATLAS_SLOTS; ++i) {
+		tReadout &r = slot[i];
+		if (!r.valid) continue;
+		if (x < r.x + r.width && r.x < x + width && y < r.y + h && r.y < y + height)
+			r.valid = false;
+	}
+}
+
+int8_t DIGIT_ATLAS::cellIndex(char sym) {
+	const char *p = strchr(ATLAS_SYMBOLS, sym);
+	if (!p || sym == '\0') return -1;
+	return index[p - ATLAS_SYMBOLS];
+}
+
+// Draw the atlas cell, the negative cell index means blank cell
+void DIGIT_ATLAS::drawCell(uint16_t x, uint16_t y, int8_t cell, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t h = atlas.height();
+	if (cell < 0) {
+		TFT_DrawFilledRect(x, y, cell_w, h, bg_color);
+	} else {
+		uint16_t part_x = cell * cell_stride;
+		TFT_DrawBitmapPart(x, y, atlas.bitmap(), atlas.width(), h, part_x, 0, cell_w, h, bg_color, fg_color);
+	}
+	pushed += cell_w * h;
+}
+
+// Find the readout slot by its position or use the least recently used one
+DIGIT_ATLAS::tReadout& DIGIT_ATLAS::readout(uint16_t x, uint16_t y, uint16_t width) {
+	uint8_t lru = 0;
+	for (uint8_t i = 0; i < ATLAS_SLOTS; ++i) {
+		tReadout &r = slot[i];
+		if (r.x == x && r.y == y && r.width == width)
+			return r;
+		if (r.used < slot[lru].used)
+			lru = i;
+	}
+	tReadout &r = slot[lru];
+	r.x		= x;
+	r.y		= y;
+	r.width	= width;
+	r.len	= 0;
+	r.valid	= false;
+	return r;
+}
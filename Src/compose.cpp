@@ -0,0 +1,108 @@
+/*
+ * compose.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The dirty-tile compositor of the display widgets, see compose.h
+ */
+
+#include <string.h>
+#include "compose.h"
+#include "common.h"
+
+void COMPOSER::draw(uint16_t x, uint16_t y, BITMAP &bm, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t w = bm.width();
+	uint16_t h = bm.height();
+	if (w == 0 || h == 0) return;
+	uint16_t bytes_per_row	= (w + 7) >> 3;
+	uint8_t	 *cur			= bm.bitmap();
+	int8_t	 i				= findSlot(x, y, w, h);
+	if (i < 0 || !slot[i].valid || slot[i].bg != bg_color || slot[i].fg != fg_color) {
+		TFT_DrawBitmap(x, y, w, h, cur, w, bg_color, fg_color);
+		pushed += w * h;
+		if (i < 0) i = newSlot(w, h);
+		if (i < 0) return;									// Not enough memory to keep the shadow bitmap, always draw whole bitmap
+		memcpy(slot[i].shadow.bitmap(), cur, bytes_per_row * h);
+		slot[i].x		= x;
+		slot[i].y		= y;
+		slot[i].bg		= bg_color;
+		slot[i].fg		= fg_color;
+		slot[i].valid	= true;
+		slot[i].used	= ++use_cnt;
+		return;
+	}
+
+	uint8_t *old = slot[i].shadow.bitmap();
+	for (uint16_t ty = 0; ty < h; ty += COMP_TILE_H) {
+		uint16_t th = (h - ty < COMP_TILE_H)?h - ty:COMP_TILE_H;
+		int16_t  run = -1;									// The first byte column of the changed tiles run
+		for (uint16_t col = 0; col <= bytes_per_row; ++col) {
+			bool dirty = false;
+			if (col < bytes_per_row) {
+				for (uint16_t r = ty; r < ty + th; ++r) {
+					uint32_t k = r * bytes_per_row + col;
+					if (cur[k] != old[k]) {
+						dirty = true;
+						break;
+					}
+				}
+			}
+			if (dirty) {
+				if (run < 0) run = col;
+			} else if (run >= 0) {							// Send the merged run of changed tiles
+				uint16_t px = run << 3;
+				uint16_t pw = (col - run) << 3;
+				if (px + pw > w) pw = w - px;
+				TFT_DrawBitmapPart(x + px, y + ty, cur, w, h, px, ty, pw, th, bg_color, fg_color);
+				pushed += pw * th;
+				run = -1;
+			}
+		}
+	}
+	memcpy(old, cur, bytes_per_row * h);
+	slot[i].used = ++use_cnt;
+}
+
+void COMPOSER::invalidate(void) {
+	for (uint8_t i = 0; i < COMP_SLOTS; ++i)
+		slot[i].valid = false;
+}
+
+void COMPOSER::invalidate(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	for (uint8_t i = 0; i < COMP_SLOTS; ++i) {
+		tSlot &s = slot[i];
+		if (!s.valid) continue;
+		if (x < s.x + s.shadow.width() && s.x < x + width && y < s.y + s.shadow.height() && s.y < y + height)
+			s.valid = false;
+	}
+}
+
+int8_t COMPOSER::findSlot(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	for (uint8_t i = 0; i < COMP_SLOTS; ++i) {
+		tSlot &s = slot[i];
+		if (s.x == x && s.y == y && s.shadow.width() == width && s.shadow.height() == height)
+			return i;
+	}
+	return -1;
+}
+
+// Use the free slot or the least recently used one. Reallocate the shadow bitmap if the size is different
+int8_t COMPOSER::newSlot(uint16_t width, uint16_t height) {
+	uint8_t lru = 0;
+	for (uint8_t i = 0; i < COMP_SLOTS; ++i) {
+		if (slot[i].shadow.width() == 0) {					// Not allocated yet
+			lru = i;
+			break;
+		}
+		if (slot[i].used < slot[lru].used)
+			lru = i;
+	}
+	tSlot &s = slot[lru];
+	s.valid = false;
+	if (s.shadow.width() != width || s.shadow.height() != height) {
+		s.shadow = BITMAP();								// Free the memory first
+		s.shadow = BITMAP(width, height);
+		if (s.shadow.width() == 0) return -1;
+	}
+	return lru;
+}
@@ -57,6 +57,14 @@
  *  	Added CFG_CORE::minFanSpeed(), CFG_CORE::maxFanSpeed(), CFG_CORE::isFan24v(), CFG_CORE::gunFanPresetPcnt()
  *  	Modified CFG_CORE::gunFanPreset()
  *  	Added new parameter into CFG_CORE::setupGUN()
+ *  2026 OCT 16, v.1.13
+ *  	Added the learned tip thermal model into the tip record
+ *  	Modified CFG::selectTip() to load the tip model even if the tip is not calibrated
+ *  	Modified CFG::saveTipCalibtarion() to reset the tip model, it should be learned again in new internal units
+ *  	Added CFG::saveTipModel()
+ *  	Added new parameter into CFG_CORE::setupGUN(), the Hot Air Gun sigma-delta power modulator
+ *  	The known tip record index is passed to the W25Q::saveTipData(), so the tip record is not looked for in the flash
+ *  	Added CFG::fullTipName() to build the tip list without memory allocation
  */
 
 #include <stdlib.h>
@@ -129,14 +137,6 @@ CFG_STATUS CFG::init(void) {
 	return CFG_OK;
 }
 
-bool CFG::reloadTips(void) {
-	if (tip_table) {
-		buildTipTable(tip_table);
-		return true;
-	}
-	return false;
-}
-
 void CFG::correctConfig(RECORD *cfg) {
 	uint16_t t12_tempC = cfg->t12_temp;
 	uint16_t jbc_tempC = cfg->jbc_temp;
@@ -197,6 +197,7 @@ bool CFG::selectTip(tDevice dev_type, uint8_t index) {
 		} else {											// Tip configuration record is completely correct
 			TIP_CFG::load(tip, dev_type);
 		}
+		TIP_CFG::loadModel(tip, dev_type);
 	}
 	return result;
 }
@@ -334,11 +335,14 @@ bool CFG::saveTipCalibtarion(uint8_t index, uint16_t temp[4], uint8_t mask, int8
 	tip.t400		= temp[3];
 	tip.mask		= mask;
 	tip.ambient		= ambient;
+	tip.heat_cap	= 0;									// The tip model should be learned again
+	tip.heat_loss	= 0;
 	tip_table[index].tip_mask	= mask;
 	const char* name	= TIPS::name(index);
 	if (name && isValidTipConfig(&tip)) {
 		strncpy(tip.name, name, tip_name_sz);
-		int16_t tip_index = saveTipData(&tip);
+		int16_t hint = (tip_table[index].tip_index == NO_TIP_CHUNK)?-1:tip_table[index].tip_index;
+		int16_t tip_index = saveTipData(&tip, false, hint);
 		if (tip_index >= 0) {
 			tip_table[index].tip_index	= tip_index;
 			tip_table[index].tip_mask	= mask;
@@ -371,7 +375,7 @@ bool CFG::toggleTipActivation(uint8_t index) {
 	}
 	if (!ret) return false;
 
-	tip_index = saveTipData(&tip, true);
+	tip_index = saveTipData(&tip, true, (tip_index == NO_TIP_CHUNK)?-1:tip_index);
 	if (tip_index >= 0  && tip_index < TIPS::total()) {
 		tip_table[index].tip_index	= tip_index;
 		tip_table[index].tip_mask	= tip.mask;
@@ -380,6 +384,33 @@ bool CFG::toggleTipActivation(uint8_t index) {
 	return false;
 }
 
+/*
+ * Save the learned thermal model of the active IRON tip (see tmodel.h) to the FLASH if the model has been changed significantly.
+ * Called when the IRON is turned-off to minimize FLASH writes
+ */
+bool CFG::saveTipModel(tDevice dev, uint16_t capacity, uint16_t loss) {
+	if (!tip_table || (dev != d_t12 && dev != d_jbc)) return false;
+	if (capacity == 0 || loss == 0) return false;			// The model has not been learned yet
+	uint16_t c = TIP_CFG::heatCapacity(dev);
+	uint16_t l = TIP_CFG::heatLoss(dev);
+	uint16_t c_diff = (capacity > c)?(capacity - c):(c - capacity);
+	uint16_t l_diff = (loss > l)?(loss - l):(l - loss);
+	if (c_diff <= (c >> model_diff_shift) && l_diff <= (l >> model_diff_shift))
+		return true;										// The model is almost the same as saved one
+	uint8_t tip_index = tip_table[currentTipIndex(dev)].tip_index;
+	if (tip_index == NO_TIP_CHUNK)							// The tip record does not exist in the FLASH
+		return false;
+	TIP tip;
+	if (loadTipData(&tip, tip_index) != TIP_OK)
+		return false;
+	tip.heat_cap	= capacity;
+	tip.heat_loss	= loss;
+	if (saveTipData(&tip, false, tip_index) != tip_index)
+		return false;
+	TIP_CFG::loadModel(tip, dev);
+	return true;
+}
+
  // Build the tip list starting from the previous tip
 int	CFG::tipList(uint8_t current, TIP_ITEM list[], uint8_t list_len, bool active_only, tDevice dev_type) {
 	if (!tip_table) {										// If tip_table is not initialized, return empty list
@@ -413,8 +444,7 @@ int	CFG::tipList(uint8_t current, TIP_ITEM list[], uint8_t list_len, bool active
 		}
 		list[loaded].tip_index	= tip_index;
 		list[loaded].mask		= tip_table[tip_index].tip_mask;
-		std::string tip_name	= buildFullTipName(tip_index);
-		strncpy(list[loaded].name, tip_name.c_str(), tip_name_sz+5);
+		fullTipName(tip_index, list[loaded].name);
 		++loaded;
 		if (loaded >= list_len)	break;
 	}
@@ -547,22 +577,25 @@ uint8_t	CFG::buildTipTable(TIP_TABLE tt[]) {
 
 // Build full name of the current tip. Add prefix "T12-" for the "usual" tip or use complete name for "N*" tips
 std::string CFG::buildFullTipName(const uint8_t index) {
+	char tip_name[tip_name_sz+5];
+	fullTipName(index, tip_name);
+	return std::string(tip_name);
+}
+
+// Build full name of the tip into the buffer of tip_name_sz+5 characters
+void CFG::fullTipName(const uint8_t index, char full_name[]) {
 	const char *name = TIPS::name(index);
-	std::string tip_name(name, tip_name_sz);
-	if (name) {
-		if (index == 0 || name[0] == 'N') {					// Do not modify Hot Air Gun 'tip' name nor N* names
-			return tip_name;
-		} else {
-			if (index < TIPS::jbcFirstIndex()) {			// T12 tip name
-				tip_name.insert(0, "T12-");
-			} else {										// JBC tip name
-				tip_name.insert(0, "JBC-");
-			}
-		}
-	} else {
-		tip_name = std::string("NONE");
+	if (!name) {
+		strcpy(full_name, "NONE");
+		return;
+	}
+	uint8_t n = 0;
+	if (index != 0 && name[0] != 'N') {						// Do not modify Hot Air Gun 'tip' name nor N* names
+		strcpy(full_name, (index < TIPS::jbcFirstIndex())?"T12-":"JBC-");
+		n = 4;
 	}
-	return tip_name;
+	strncpy(&full_name[n], name, tip_name_sz);
+	full_name[n + tip_name_sz] = '\0';
 }
 
 // Compare two configurations
@@ -732,7 +765,7 @@ void CFG_CORE::setupJBC(uint8_t off_timeout, uint16_t stby_temp) {
 	a_cfg.jbc_off_timeout	= constrain(off_timeout, 0, 30);
 }
 
-void CFG_CORE::setupGUN(bool fast_gun_chill, bool is_fan_24v, uint8_t stby_timeout, uint16_t stby_temp) {
+void CFG_CORE::setupGUN(bool fast_gun_chill, bool is_fan_24v, bool sigma_delta, uint8_t stby_timeout, uint16_t stby_temp) {
 	if (fast_gun_chill) {
 		a_cfg.bit_mask		|= CFG_FAST_COOLING;
 	} else {
@@ -743,6 +776,11 @@ void CFG_CORE::setupGUN(bool fast_gun_chill, bool is_fan_24v, uint8_t stby_timeo
 	} else {
 		a_cfg.bit_mask		&= ~CFG_FAN_24;
 	}
+	if (sigma_delta) {
+		a_cfg.bit_mask		|= CFG_GUN_SD;
+	} else {
+		a_cfg.bit_mask		&= ~CFG_GUN_SD;
+	}
 	a_cfg.gun_off_timeout	= stby_timeout;
 	a_cfg.gun_low_temp		= stby_temp;
 }
@@ -828,6 +866,14 @@ void TIP_CFG::load(const TIP& ltip, tDevice dev) {
 	tip[i].calibration[3]	= ltip.t400;
 	tip[i].mask				= ltip.mask;
 	tip[i].ambient			= ltip.ambient;
+	loadModel(ltip, dev);
+}
+
+void TIP_CFG::loadModel(const TIP& ltip, tDevice dev) {
+	uint8_t i = uint8_t(dev);
+	if (i >= 3) return;
+	tip[i].heat_cap			= ltip.heat_cap;
+	tip[i].heat_loss		= ltip.heat_loss;
 }
 
 void TIP_CFG::dump(TIP* ltip, tDevice dev) {
@@ -838,6 +884,20 @@ void TIP_CFG::dump(TIP* ltip, tDevice dev) {
 	ltip->t400		= tip[i].calibration[3];
 	ltip->mask		= tip[i].mask;
 	ltip->ambient	= tip[i].ambient;
+	ltip->heat_cap	= tip[i].heat_cap;
+	ltip->heat_loss	= tip[i].heat_loss;
+}
+
+uint16_t TIP_CFG::heatCapacity(tDevice dev) {
+	uint8_t i = uint8_t(dev);
+	if (i >= 3) return 0;
+	return tip[i].heat_cap;
+}
+
+uint16_t TIP_CFG::heatLoss(tDevice dev) {
+	uint8_t i = uint8_t(dev);
+	if (i >= 3) return 0;
+	return tip[i].heat_loss;
 }
 
 int8_t TIP_CFG::ambientTemp(tDevice dev) {
@@ -923,6 +983,8 @@ void TIP_CFG::defaultCalibration(tDevice dev) {
 		tip[dev_indx].calibration[i] = calib_default[i];
 	tip[dev_indx].ambient	= default_ambient;					// vars.cpp
 	tip[dev_indx].mask		= TIP_ACTIVE;
+	tip[dev_indx].heat_cap	= 0;
+	tip[dev_indx].heat_loss	= 0;
 }
 
 void TIP_CFG::defaultCalibration(TIP *tip) {
@@ -931,6 +993,8 @@ void TIP_CFG::defaultCalibration(TIP *tip) {
 	tip->t260				= calib_default[i++];
 	tip->t330				= calib_default[i++];
 	tip->t400				= calib_default[i];
+	tip->heat_cap			= 0;
+	tip->heat_loss			= 0;
 }
 
 bool TIP_CFG::isValidTipConfig(TIP *tip) {
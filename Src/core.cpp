@@ -51,7 +51,7 @@
  *  array evenly. The 120-element array power data is sent via DMA channel to the TIM1_CH4 channel and manages the TRIAC. Every half of period (60)
  *  is a time of checking the Hot Air Gun temperature and calculate the required power to be applied. See HAL_TIM_PWM_PulseFinishedHalfCpltCallback()
  *  and HAL_TIM_PWM_PulseFinishedCallback() callbacks. As soon as required power calculated (0-120 half-period shapes) this number of half-period
- *  shapes is distributed into 120 elements DMA buffer (gun_pwr) by the calculateGunPowerData() routine. Active pulse encoded as 70 (TIM1 ticks)
+ *  shapes is distributed into 120 elements DMA buffer (gun_pwr) by the fillGunPowerData() routine. Active pulse encoded as 70 (TIM1 ticks)
  *  and inactive pulse is encoded as 0. As mentioned before, the TIM1 timer counts from 0 to 100 (or 83 in USA) before AC_ZERO interrupt resets
  *  the timer and the 70-ticks long active pulse activates the TRIAC at the AV wave beginning and goes down before the sine pulse ends, but
  *  the TRIAC keeps open until the AC sine wave goes through the zero, so the half-period shape will propagate to the Hot Air Gun completely.
@@ -73,6 +73,21 @@
  * 		Changed the TIM1 initialization
  * 		Created gun_pwr[] DMA buffer to transfer the power parameter to the TIM1_CH4
  * 		Created calculateGunPowerData() and powerOffGun() routines
+ *  2026 OCT 16, v.1.13
+ *  	Added ISR profiler (see isrprof.h) to measure the control path IRQ handlers duration: HAL_TIM_OC_DelayElapsedCallback(),
+ *  	adcStartTemp(), HAL_ADC_ConvCpltCallback() and IRON::power(). The profiler is enabled by ISR_PROFILE macro in main.h
+ *  	Added temperature oversampling mode (ADC_OVERSAMPLE macro in main.h), see adcOversampleInit()
+ *  	Replaced polled loop() with the task scheduler (see sched.h): checkSwitches(), checkAC(), adjustBrightness() and modeLoop()
+ *  	are periodic tasks now, the CPU sleeps between the tasks. Removed HAL_Delay() from the brightness adjustment
+ *  	Added schedLateness() to show the worst task activation delay in the debug mode
+ *  	Replaced the blocking syncAC() and checkAC() task with the AC zero-cross tracker (see actrack.h) called from TIM1 IRQ handler.
+ *  	The TIM1 update event is the zero-cross if the TIM1 trigger flag is set, otherwise the TIM1 overflowed and there is no AC signal
+ *  	Replaced calculateGunPowerData() with fillGunPowerData(). All 121 power patterns are built at compile time, see gun_pattern.h
+ *  	Added the first-order sigma-delta modulator of the Hot Air Gun power, fillGunPowerSD(). The modulator carries the fractional
+ *  	power remainder across the DMA half-buffers. Selected in the Hot Air Gun setup menu instead of the power patterns
+ *  	Added the control path telemetry (ISR_TELEMETRY macro in main.h): HAL_ADC_ConvCpltCallback() writes the samples into the lock-free
+ *  	ring buffer (see telemetry.h), drainTelemetry() scheduler task reads them in the main loop
+ *  	modeLoop() commits the frame of the retained display scene after the mode loop (UI_RETAINED macro in main.h, see scene.h)
  */
 
 #include <math.h>
@@ -82,11 +97,14 @@
 #include "work_mode.h"
 #include "menu.h"
 #include "vars.h"
+#include "sched.h"
+#include "actrack.h"
+#include "gun_pattern.h"
 
 #define ADC_T12 	(4)										// Activated ADC Ranks Number (hadc1.Init.NbrOfConversion)
 #define ADC_JBC 	(2)										// Activated ADC Ranks Number (hadc2.Init.NbrOfConversion)
 #define ADC_CUR		(3)										// Activated ADC Ranks Number (hadc3.Init.NbrOfConversion)
-#define MAX_GUN_POWER		(120)
+#define MAX_GUN_POWER		(GUN_SLOTS)
 
 extern ADC_HandleTypeDef	hadc1;
 extern ADC_HandleTypeDef	hadc2;
@@ -100,17 +118,34 @@ volatile static t_ADC_mode	adc_mode = ADC_IDLE;
 volatile static uint16_t	t12_buff[ADC_T12];				// Hakko T12 temperature and ambient temperature sensor in T12 handle
 volatile static uint16_t	jbc_buff[ADC_JBC];				// JBC temperature and Hot Air Gun temperature
 volatile static uint16_t	cur_buff[ADC_CUR];				// Currents: T12, JBC, Fan
-volatile static	uint32_t	tim1_cntr	= 0;				// Previous value of TIM1 counter. Using to check the TIM1 value changing
+#ifdef ADC_OVERSAMPLE
+#if ADC_OVERSAMPLE < 2 || ADC_OVERSAMPLE > 8
+#error "ADC_OVERSAMPLE should be in the range 2-8"
+#endif
+#define ADC_T12_OS	(ADC_OVERSAMPLE + ADC_T12 - 1)			// Over-sampled T12 temperature, ambient, VREFINT and MCU temperature
+#define ADC_JBC_OS	(ADC_OVERSAMPLE * ADC_JBC)				// Over-sampled JBC temperature and Hot Air Gun temperature
+volatile static uint16_t	t12_os_buff[2][ADC_T12_OS];		// Circular DMA ping-pong buffer of ADC1
+volatile static uint16_t	jbc_os_buff[2][ADC_JBC_OS];		// Circular DMA ping-pong buffer of ADC2
+#endif
 volatile static	bool		ac_sine		= false;			// Flag indicating that TIM1 is driven by AC power interrupts on AC_ZERO pin
 volatile static bool		jbc_phase	= true;				// JBC or T12 active phase, see description above
 volatile static uint16_t	t12_power	= 0;				// Calculated power of T12 iron
 volatile static uint16_t	jbc_power	= 0;				// Calculated power of JBC iron
 volatile static uint16_t	gun_pwr[MAX_GUN_POWER*2] = {0};	// The HOT GUN power PWM buffer
-static	EXPA				gtim_period;					// gun timer period (ms)
+static	ACTRACK				ac_track;						// AC zero-cross tracker, aligns TIM5 to AC power
+static constexpr GUN_PATTERN gun_pattern;					// The Hot Air Gun power patterns built by the compiler
+static_assert(gun_pattern.verify(), "Wrong Hot Air Gun power pattern");
+static	uint16_t			gun_sd_acc	= 0;				// The Hot Air Gun sigma-delta modulator accumulator
+static	ISRPROF				prof;							// The control path IRQ handlers profiler
+static	TELEMETRY			tlm;							// The control path samples passed from the ADC IRQ handler to the main loop
+volatile static uint32_t	temp_path_begin	= 0;			// The cycle counter value at TIM5 CH4 compare event
 static  uint16_t  			max_iron_pwm	= 0;			// Max value should be less than TIM5.CH3 value by 40. Will be initialized later
-volatile static uint32_t	gtim_last_ms	= 0;			// Time when the gun timer became zero
 const static	uint16_t  	max_gun_pwm		= 99;			// TIM1 period. Full power can be applied to the HOT GUN
 const static	uint32_t	check_sw_period = 100;			// IRON switches check period, ms
+const static	uint32_t	brgt_period		= 5;			// Display brightness adjustment step period, ms
+const static	uint32_t	mode_period		= 1;			// Working mode loop period, ms
+const static	uint32_t	tlm_period		= 20;			// Telemetry drain period, ms. Less than the ring buffer duration
+static	SCHED				sched;							// The main loop tasks scheduler
 
 static HW		core;										// Hardware core (including all device instances)
 
@@ -138,72 +173,218 @@ static	MMENU			main_menu(&core, &iselect, &param_menu, &activate, &t12_menu, &jb
 static	MODE*           pMode = &work;
 
 bool 		isACsine(void)		{ return ac_sine; 				}
-uint16_t	gtimPeriod(void)	{ return gtim_period.read();	}
-
-// Synchronize TIM5 timer to AC power. The main timer managing T12 & JBC irons
-static uint16_t syncAC(uint16_t tim_cnt) {
-	uint32_t to = HAL_GetTick() + 300;						// The timeout
-	while (HAL_GetTick() < to) {							// Prevent hang
-		if (TIM1->CNT == 0) {								// AC_ZERO interrupt restarts the TIM1 timer
-			TIM5->CNT = tim_cnt;							// Synchronize TIM5 to AC power zero crossing signal
-			break;
-		}
-	}
-	// Checking the TIM5 has been synchronized
-	to = HAL_GetTick() + 300;
-	while (HAL_GetTick() < to) {
-		if (TIM1->CNT == 0) {
-			return TIM2->CNT;
-		}
-	}
-	return TIM5->ARR+1;										// This value is bigger than TIM5 period, the TIM5 has not been synchronized
+uint16_t	gtimPeriod(void)	{ return ac_track.halfPeriod();	}
+uint16_t	acFrequency(void)	{ return ac_track.frequency();	}
+uint16_t	acJitter(void)		{ return ac_track.jitter();		}
+bool		isACLocked(void)	{ return ac_track.isLocked();	}
+uint32_t	isrWorstCycles(tPrfStage stage)	{ return prof.worst(stage);	}
+uint32_t	isrBudgetCycles(void)			{ return prof.budget();		}
+void		isrResetProfile(void)			{ prof.reset();				}
+uint16_t	telemetryRate(tTlmPhase phase)	{ return tlm.rate(phase);	}
+uint16_t	telemetryAvgPower(tTlmPhase phase)	{ return tlm.avgPower(phase);	}
+uint16_t	telemetryMaxPower(tTlmPhase phase)	{ return tlm.maxPower(phase);	}
+uint16_t	telemetryRipple(tTlmPhase phase)	{ return tlm.ripple(phase);	}
+uint32_t	telemetryDropped(void)			{ return tlm.dropped();		}
+
+// The worst main loop task activation delay since the previous call, ms
+uint32_t schedLateness(void) {
+	uint32_t late = sched.maxLateness();
+	sched.resetStat();
+	return late;
 }
 
-// Calculates the PWM value data for TIMER to supply power to the heater
+// Fills the PWM value data for TIMER to supply power to the heater
 // Each AC-outlet peak (100 Hz in Russia and 60 Hz in US) resets the timer and make the timer to supply power
-// The PWM values can be in two states: supply power for the half-period (peak) or not
-static void calculateGunPowerData(volatile uint16_t *data, uint8_t max_power, uint8_t pwr) {
+// The PWM values can be in two states: supply power for the half-period (peak) or not. The pattern is built at compile time, see gun_pattern.h
+static void fillGunPowerData(volatile uint16_t *data, uint8_t pwr) {
 	const uint8_t active_pulse = 70;
-	uint8_t on	= active_pulse;
-	uint8_t off = 0;
-	if (pwr > (max_power >> 1)) {							// In case the pwr is greater than half of maximum power, calculate positions of "empty" peaks
-		if (pwr > max_power) pwr = max_power;
-		on	= 0;
-		off = active_pulse;
-		pwr = max_power - pwr;
-	}
-	if (pwr == 0) {											// No power supplied at all, empty all PWM slots
-		for (uint8_t i = 0; i < max_power; ++i)
-			data[i] = off;
-		return;
+	const uint8_t *mask = gun_pattern.pattern(pwr);
+	for (uint8_t i = 0; i < GUN_MASK_SIZE; ++i) {
+		uint8_t m = mask[i];
+		for (uint8_t b = 0; b < 8; ++b) {
+			*data++	= (m & 1)?active_pulse:0;
+			m >>= 1;
+		}
 	}
-	uint8_t slots	= max_power / pwr;						// Number of PWM slots per each "powered" peak (0 .. max_power/2)
-	uint8_t remain	= max_power % pwr;						// The division remainder
-	uint8_t pos		= slots >> 1;							// Put the "powered" peak in to the center of the slot
-	int8_t extra	= 0;									// Extra position remainder (extra/pwr)
-	for (uint8_t i = 0; i < max_power; ++i) {
-		if (i < pos) {
-			data[i] = off;
+}
+
+// The first-order sigma-delta modulator: supply the power to the half-period when the accumulated power exceeds one half-period.
+// The power (pwr) has GUN_POWER_Q fractional bits. The remainder is kept in the accumulator to be applied in the next DMA half-buffer
+static void fillGunPowerSD(volatile uint16_t *data, uint16_t pwr) {
+	const uint8_t	active_pulse	= 70;
+	const uint16_t	full			= GUN_SLOTS << GUN_POWER_Q;	// The accumulator threshold
+	for (uint8_t i = 0; i < GUN_SLOTS; ++i) {
+		gun_sd_acc += pwr;
+		if (gun_sd_acc >= full) {
+			gun_sd_acc -= full;
+			*data++	= active_pulse;
 		} else {
-			data[i] = on;
-			pos += slots;
-			extra += remain;
-			if (extra + (remain>>1) >= pwr) {
-				++pos;
-				extra -= pwr;
-			}
+			*data++	= 0;
 		}
 	}
 }
 
+#ifdef ADC_OVERSAMPLE
+// Read the channel number of the regular sequence rank (0-15) from the ADC sequence registers
+static uint8_t adcRankChannel(ADC_TypeDef *adc, uint8_t rank) {
+	volatile uint32_t *sqr = (rank < 6)?&adc->SQR3:((rank < 12)?&adc->SQR2:&adc->SQR1);
+	return (*sqr >> ((rank % 6) * 5)) & 0x1F;
+}
+
+static void adcSetRankChannel(ADC_TypeDef *adc, uint8_t rank, uint8_t channel) {
+	volatile uint32_t *sqr = (rank < 6)?&adc->SQR3:((rank < 12)?&adc->SQR2:&adc->SQR1);
+	uint8_t shift = (rank % 6) * 5;
+	*sqr = (*sqr & ~(0x1FU << shift)) | ((uint32_t)channel << shift);
+}
+
+/*
+ * Build new regular sequence of the ADC by repeating the ranks configured by CubeMX. The sample time is per channel, so it is kept.
+ * repeat[] is the number of times the original rank should be repeated in the sequence
+ */
+static void adcRepeatRanks(ADC_HandleTypeDef *hadc, uint8_t ranks, const uint8_t repeat[]) {
+	uint8_t channel[ADC_T12];
+	for (uint8_t i = 0; i < ranks; ++i)
+		channel[i] = adcRankChannel(hadc->Instance, i);
+	uint8_t len = 0;
+	for (uint8_t i = 0; i < ranks; ++i) {
+		for (uint8_t n = 0; n < repeat[i]; ++n)
+			adcSetRankChannel(hadc->Instance, len++, channel[i]);
+	}
+	hadc->Instance->SQR1 = (hadc->Instance->SQR1 & ~ADC_SQR1_L) | ((uint32_t)(len - 1) << ADC_SQR1_L_Pos);
+	hadc->Init.NbrOfConversion			= len;
+	hadc->Init.DMAContinuousRequests	= ENABLE;
+	hadc->Instance->CR2 |= ADC_CR2_DDS;						// Keep DMA requests after the last transfer, the DMA is circular
+	HAL_DMA_DeInit(hadc->DMA_Handle);
+	hadc->DMA_Handle->Init.Mode = DMA_CIRCULAR;
+	HAL_DMA_Init(hadc->DMA_Handle);
+}
+
+/*
+ * Oversampling mode of the temperature ADCs (ADC1 and ADC2).
+ * Every TIM5 CH4 event starts a burst of ADC_OVERSAMPLE conversions of the iron (and Hot Air Gun) temperature in a single sequence,
+ * so the burst stops by itself. The DMA is not restarted every phase, it works in circular mode with two halves of the buffer:
+ * the bursts fill the halves in turn and the half-complete and complete callbacks decimate the corresponding half.
+ * The whole burst should fit the TIM5 window between CH4 compare and the end of period (200 us)
+ */
+static void adcOversampleInit(void) {
+	const uint8_t t12_repeat[ADC_T12] = { ADC_OVERSAMPLE, 1, 1, 1 };
+	const uint8_t jbc_repeat[ADC_JBC] = { ADC_OVERSAMPLE, ADC_OVERSAMPLE };
+	adcRepeatRanks(&hadc1, ADC_T12, t12_repeat);
+	adcRepeatRanks(&hadc2, ADC_JBC, jbc_repeat);
+	// The first burst is started immediately and is ignored because adc_mode is ADC_IDLE
+	HAL_ADC_Start_DMA(&hadc1, (uint32_t*)t12_os_buff, 2*ADC_T12_OS);
+	HAL_ADC_Start_DMA(&hadc2, (uint32_t*)jbc_os_buff, 2*ADC_JBC_OS);
+}
+
+// Average the samples, round the result
+static uint16_t adcDecimate(volatile uint16_t *data) {
+	uint32_t sum = ADC_OVERSAMPLE >> 1;
+	for (uint8_t i = 0; i < ADC_OVERSAMPLE; ++i)
+		sum += data[i];
+	return sum / ADC_OVERSAMPLE;
+}
+
+// Decimate the temperature ADC data from the ping-pong buffer half into t12_buff[] or jbc_buff[]
+static bool adcOversampled(ADC_HandleTypeDef* hadc, uint8_t half) {
+	if (hadc == &hadc1) {
+		volatile uint16_t *data = t12_os_buff[half];
+		t12_buff[0] = adcDecimate(data);					// T12 temperature
+		for (uint8_t i = 1; i < ADC_T12; ++i)				// Ambient, VREFINT and MCU temperature are checked once
+			t12_buff[i] = data[ADC_OVERSAMPLE + i - 1];
+		return true;
+	} else if (hadc == &hadc2) {
+		volatile uint16_t *data = jbc_os_buff[half];
+		jbc_buff[0] = adcDecimate(data);					// JBC temperature
+		jbc_buff[1] = adcDecimate(&data[ADC_OVERSAMPLE]);	// Hot Air Gun temperature
+		return true;
+	}
+	return false;
+}
+#else
+static bool adcOversampled(ADC_HandleTypeDef* hadc, uint8_t half) { return false; }
+#endif
+
 static void powerOffGun(void) {
 	for (uint16_t i = 0; i < MAX_GUN_POWER * 2; ++i) {
 		gun_pwr[i] = 0;
 	}
+	gun_sd_acc = 0;
+}
+
+// Calculate the Hot Air Gun power and fill the next half of the power DMA buffer
+static void updateGunPower(volatile uint16_t *data) {
+	uint16_t gun_power	= 0;
+	if (ac_sine) {
+		core.hotgun.power();
+		gun_power	= core.hotgun.finePower();
+	}
+	if (gun_power == 0) {
+		powerOffGun();
+	} else if (core.hotgun.isSigmaDelta()) {
+		fillGunPowerSD(data, gun_power);
+	} else {
+		fillGunPowerData(data, gun_power >> GUN_POWER_Q);
+	}
+}
+
+// Scheduler task: check iron switches status
+static void checkSwitches(void) {
+	GPIO_PinState pin = HAL_GPIO_ReadPin(TILT_SW_GPIO_Port, TILT_SW_Pin);
+	core.t12.updateReedStatus(GPIO_PIN_SET == pin);			// Update T12 TILT switch status
+	pin = HAL_GPIO_ReadPin(JBC_STBY_GPIO_Port, JBC_STBY_Pin);
+	core.jbc.updateReedStatus(GPIO_PIN_SET == pin);			// Switch active when the JBC handle is off-hook
+	pin = HAL_GPIO_ReadPin(JBC_CHANGE_GPIO_Port, JBC_CHANGE_Pin);
+	core.jbc.updateChangeStatus(GPIO_PIN_RESET == pin);		// Switch active when the JBC tip on change connector
+	pin = HAL_GPIO_ReadPin(REED_SW_GPIO_Port, REED_SW_Pin);
+	core.hotgun.updateReedStatus(GPIO_PIN_SET == pin);		// Switch active when the Hot Air Gun handle is off-hook
+}
+
+#ifdef ISR_TELEMETRY
+// Scheduler task: drain the telemetry samples written by the ADC IRQ handler
+static void drainTelemetry(void) {
+	tlm.drain();
+}
+#endif
+
+// Scheduler task: adjust display brightness step by step
+static void adjustBrightness(void) {
+	core.dspl.BRGT::adjust();
+}
+
+// Scheduler task: run the current mode loop and switch the mode if required
+static void modeLoop(void) {
+	MODE* new_mode = pMode->returnToMain();
+	if (new_mode && new_mode != pMode) {
+		core.buzz.doubleBeep();
+		core.t12.switchPower(false);
+		core.jbc.switchPower(false);
+		TIM5->CCR1	= 0;									// Switch-off the IRON power immediately
+		TIM5->CCR2  = 0;
+		pMode->clean();
+		pMode = new_mode;
+		pMode->init();
+		return;
+	}
+	new_mode = pMode->loop();
+	core.dspl.commit();										// Erase the widgets of the previous screen if the new one has been drawn
+	if (new_mode != pMode) {
+		if (new_mode == 0) new_mode = &fail;				// Mode Failed
+		core.t12.switchPower(false);
+		core.jbc.switchPower(false);
+		core.hotgun.switchPower(false);
+		core.t12.setCheckPeriod(0);							// Stop checking t12 IRON
+		core.jbc.setCheckPeriod(0);							// Stop checking JBC IRON
+		TIM5->CCR1	= 0;									// Switch-off the IRON power immediately
+		TIM5->CCR2	= 0;
+		pMode->clean();
+		pMode = new_mode;
+		pMode->init();
+	}
 }
 
 extern "C" void setup(void) {
 	TIM12->CCR1 = 0;										// Do turn-off the display backlight
+	prof.init();											// Start the cycle counter if ISR profiler enabled
 	// Read temperature values
 	HAL_ADC_Start(&hadc1);
 	HAL_ADC_PollForConversion(&hadc1, 100);
@@ -221,8 +402,10 @@ extern "C" void setup(void) {
 	HAL_ADC_PollForConversion(&hadc2, 100);
 	uint16_t gun_temp 	= HAL_ADC_GetValue(&hadc2);
 	HAL_ADC_Stop(&hadc2);
-	gtim_period.length(10);
-	gtim_period.reset(1000);								// Default TIM1 period, ms
+#ifdef ADC_OVERSAMPLE
+	adcOversampleInit();									// Switch the temperature ADCs to circular DMA mode
+#endif
+	ac_track.init();
 	max_iron_pwm	= htim5.Instance->CCR4 - 40;			// Max value should be less than TIM5.CH4 value by 40.
 
 	CFG_STATUS cfg_init = core.init(t12_temp, jbc_temp, gun_temp, ambient, vref, t_mcu);
@@ -277,7 +460,6 @@ extern "C" void setup(void) {
 			break;
 	}
 
-	syncAC(0);												// Synchronize TIM5 timer to AC power. Parameter is TIM5 counter value when TIM1 become zero
 	uint8_t br = core.cfg.getDsplBrightness();
 	core.dspl.BRGT::set(br);
 	// Turn-on the display backlight immediately in the debug mode
@@ -286,63 +468,18 @@ extern "C" void setup(void) {
 #endif
 	HAL_Delay(500);											// Wait at least 0.5s to update the T12 iron tip connection status
 	pMode->init();
+
+	sched.add(checkSwitches,	check_sw_period);
+	sched.add(adjustBrightness,	brgt_period);
+	sched.add(modeLoop,			mode_period);
+#ifdef ISR_TELEMETRY
+	sched.add(drainTelemetry,	tlm_period);
+#endif
 }
 
 
 extern "C" void loop(void) {
-	static uint32_t AC_check_time	= 0;					// Time in ms when to check TIM1 is running
-	static uint32_t	check_sw		= 0;					// Time when check iron switches status (ms)
-
-	if (HAL_GetTick() > check_sw) {
-		check_sw = HAL_GetTick() + check_sw_period;
-		GPIO_PinState pin = HAL_GPIO_ReadPin(TILT_SW_GPIO_Port, TILT_SW_Pin);
-		core.t12.updateReedStatus(GPIO_PIN_SET == pin);		// Update T12 TILT switch status
-		pin = HAL_GPIO_ReadPin(JBC_STBY_GPIO_Port, JBC_STBY_Pin);
-		core.jbc.updateReedStatus(GPIO_PIN_SET == pin);		// Switch active when the JBC handle is off-hook
-		pin = HAL_GPIO_ReadPin(JBC_CHANGE_GPIO_Port, JBC_CHANGE_Pin);
-		core.jbc.updateChangeStatus(GPIO_PIN_RESET == pin);	// Switch active when the JBC tip on change connector
-		pin = HAL_GPIO_ReadPin(REED_SW_GPIO_Port, REED_SW_Pin);
-		core.hotgun.updateReedStatus(GPIO_PIN_SET == pin);	// Switch active when the Hot Air Gun handle is off-hook
-	}
-
-	MODE* new_mode = pMode->returnToMain();
-	if (new_mode && new_mode != pMode) {
-		core.buzz.doubleBeep();
-		core.t12.switchPower(false);
-		core.jbc.switchPower(false);
-		TIM5->CCR1	= 0;									// Switch-off the IRON power immediately
-		TIM5->CCR2  = 0;
-		pMode->clean();
-		pMode = new_mode;
-		pMode->init();
-		return;
-	}
-	new_mode = pMode->loop();
-	if (new_mode != pMode) {
-		if (new_mode == 0) new_mode = &fail;				// Mode Failed
-		core.t12.switchPower(false);
-		core.jbc.switchPower(false);
-		core.hotgun.switchPower(false);
-		core.t12.setCheckPeriod(0);							// Stop checking t12 IRON
-		core.jbc.setCheckPeriod(0);							// Stop checking JBC IRON
-		TIM5->CCR1	= 0;									// Switch-off the IRON power immediately
-		TIM5->CCR2	= 0;
-		pMode->clean();
-		pMode = new_mode;
-		pMode->init();
-	}
-
-	// If TIM1 counter has been changed since last check, we received AC_ZERO events from AC power
-	if (HAL_GetTick() >= AC_check_time) {
-		ac_sine		= (TIM1->CNT != tim1_cntr);
-		tim1_cntr	= TIM1->CNT;
-		AC_check_time = HAL_GetTick() + 41;					// 50Hz AC line generates 100Hz events. The pulse period is 10 ms
-	}
-
-	// Adjust display brightness
-	if (core.dspl.BRGT::adjust()) {
-		HAL_Delay(5);
-	}
+	sched.run();											// Run ready tasks or sleep till the next interrupt
 }
 
 static bool adcStartCurrent(void) {							// Check the current by ADC3
@@ -364,12 +501,19 @@ static bool adcStartTemp(void) {							// Check the temperature by ADC1 & ADC2
     	TIM1->CCR4 = 0;										// Switch off the Hot Air Gun
 		return false;
     }
+    uint32_t begin = prof.start();
+#ifdef ADC_OVERSAMPLE
+    ADC_HandleTypeDef *hadc = (jbc_phase)?&hadc2:&hadc1;
+    hadc->Instance->CR2 |= ADC_CR2_SWSTART;					// The circular DMA is running, just start the next burst
+#else
     if (jbc_phase) {
     	HAL_ADC_Start_DMA(&hadc2, (uint32_t*)jbc_buff, ADC_JBC);
     } else {
     	HAL_ADC_Start_DMA(&hadc1, (uint32_t*)t12_buff, ADC_T12);
     }
+#endif
 	adc_mode = ADC_TEMP;
+	prof.stop(PRF_ADC_START, begin);
 	return true;
 }
 
@@ -381,11 +525,14 @@ static bool adcStartTemp(void) {							// Check the temperature by ADC1 & ADC2
  */
 extern "C" void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim) {
 	if (htim->Instance == TIM5) {
+		uint32_t begin = prof.start();
 		if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_3) {
 			adcStartCurrent();
 		} else if (htim->Channel == HAL_TIM_ACTIVE_CHANNEL_4) {
+			temp_path_begin = begin;						// The temperature path starts here and finishes in HAL_ADC_ConvCpltCallback()
 			adcStartTemp();
 		}
+		prof.stop(PRF_TIM_OC, begin);
 	}
 }
 
@@ -399,13 +546,17 @@ extern "C" void HAL_TIM_OC_DelayElapsedCallback(TIM_HandleTypeDef *htim) {
  *   The result is in jbc_buff[] array: JBC temperature, Gun temperature
  * When jbc_phase is false, , the T12 temperature and ambient temperature are checked by ADC1
  *   The result is in t12_buff[] array: T12 temperature, Ambient temperature, VREFINT, MCU internal temperature
+ * In oversampling mode the temperature ADC data are decimated into the same arrays first, see adcOversampled()
  */
-extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
-	HAL_ADC_Stop_DMA(hadc);
+static void adcDataReady(void) {
 	if (adc_mode == ADC_TEMP) {								// Checking the temperature
 		if (jbc_phase) {
 			// Check the JBC temperature and calculate the power supplied to the JBC IRON
+			uint32_t pwr_begin = prof.start();
 			jbc_power = core.jbc.power(jbc_buff[0]);
+			prof.stop(PRF_IRON_POWER, pwr_begin);
+			tlm.put(TLM_JBC, jbc_buff[0], jbc_power);
+			tlm.put(TLM_GUN, jbc_buff[1], core.hotgun.appliedPower());
 			if (jbc_power > max_iron_pwm) {					// The required power is greater than timer period (see vars.cpp)
 					TIM5->CCR2	= max_iron_pwm;				// Use full period PWM
 				jbc_power	-= max_iron_pwm;				// And save extra power to the next phase
@@ -418,7 +569,10 @@ extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
 			core.hotgun.updateTemp(jbc_buff[1]);			// The Hot Air Gun temperature
 		} else {
 			// Check the T12 temperature and calculate the power supplied to the T12 IRON
+			uint32_t pwr_begin = prof.start();
 			t12_power = core.t12.power(t12_buff[0]);
+			prof.stop(PRF_IRON_POWER, pwr_begin);
+			tlm.put(TLM_T12, t12_buff[0], t12_power);
 			if (t12_power > max_iron_pwm) {					// The required power is greater than the single timer period
 				TIM5->CCR1	= max_iron_pwm;					// Use full period PWM
 				t12_power	-= max_iron_pwm;				// And save extra power to the next phase
@@ -432,6 +586,7 @@ extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
 			core.updateIntTemp(t12_buff[2], t12_buff[3]);	// The t12_buff[2] is VREFINT, t12_buff[3] is t_mcu
 		}
 		jbc_phase = !jbc_phase;
+		prof.stop(PRF_TEMP_PATH, temp_path_begin);
 	} else if (adc_mode == ADC_CURRENT) {					// Read the currents
 		if (TIM5->CCR1 > 1) {								// The T12 iron has been powered
 			core.t12.updateCurrent(cur_buff[0]);
@@ -447,16 +602,31 @@ extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
 	adc_mode = ADC_IDLE;
 }
 
+extern "C" void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc) {
+	uint32_t begin = prof.start();
+	if (!adcOversampled(hadc, 1))							// The second half of the circular ping-pong buffer is ready
+		HAL_ADC_Stop_DMA(hadc);								// Single conversion mode, stop the DMA
+	adcDataReady();
+	prof.stop(PRF_ADC_CPLT, begin);
+}
+
+#ifdef ADC_OVERSAMPLE
+extern "C" void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc) {
+	uint32_t begin = prof.start();
+	if (adcOversampled(hadc, 0))							// The first half of the circular ping-pong buffer is ready
+		adcDataReady();
+	prof.stop(PRF_ADC_CPLT, begin);
+}
+#endif
+
 // IRQ handler for Gun power timer (TIM1). Checking for AC interrupts
 // TIM7 used to play songs
 extern "C" void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
 	if (htim->Instance == TIM1) {
-		uint32_t tm		= HAL_GetTick();
-		ac_sine			= gtim_last_ms + 30 > tm;			// Last TIM3 external interrupt was less than 30 ms before. 50Hz outlet interrupt period is 10 ms
-		if (ac_sine && gtim_last_ms > 0) {
-			gtim_period.update((tm - gtim_last_ms) * 100);
-		}
-		gtim_last_ms	= tm;
+		ac_sine	= (TIM1->SR & TIM_SR_TIF) != 0;				// AC_ZERO signal reset the timer. Otherwise, TIM1 overflowed, no AC signal for 25.6 ms
+		TIM1->SR = ~TIM_SR_TIF;
+		if (ac_sine)
+			ac_track.zeroCross(HAL_GetTick());				// Measure AC frequency and align TIM5 to the zero-cross
 	} else if (htim->Instance == TIM7) {
 		core.buzz.playSongCB();
 	}
@@ -465,27 +635,13 @@ extern "C" void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim) {
 // Gun power DMA circular buffer routine
 void HAL_TIM_PWM_PulseFinishedHalfCpltCallback(TIM_HandleTypeDef *htim) {
 	if (htim->Instance != TIM1) return;
-	uint16_t gun_power	= 0;								// First half of the pwr_buffer has been sent, calculate next buffer values
-	if (ac_sine)
-		gun_power	= core.hotgun.power();
-	if (gun_power) {
-		calculateGunPowerData(&gun_pwr[MAX_GUN_POWER], MAX_GUN_POWER, gun_power);
-	} else {
-		powerOffGun();
-	}
+	updateGunPower(&gun_pwr[MAX_GUN_POWER]);				// First half of the pwr_buffer has been sent, calculate next buffer values
 }
 
 // Gun power DMA circular buffer routine
 void HAL_TIM_PWM_PulseFinishedCallback(TIM_HandleTypeDef *htim) {
 	if (htim->Instance != TIM1) return;
-	uint16_t gun_power	= 0;								// Second half of the pwr_buffer has been sent, calculate next buffer values
-	if (ac_sine)
-		gun_power	= core.hotgun.power();
-	if (gun_power) {
-		calculateGunPowerData(gun_pwr, MAX_GUN_POWER, gun_power);
-	} else {
-		powerOffGun();
-	}
+	updateGunPower(gun_pwr);								// Second half of the pwr_buffer has been sent, calculate next buffer values
 }
 
 extern "C" void HAL_ADC_ErrorCallback(ADC_HandleTypeDef *hadc) 				{ }
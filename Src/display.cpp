@@ -16,6 +16,15 @@
  *  	Implemented the pre-heat phase in calibration modes: modified the DSPL::calibShow() and DSPL::calibManualShow()
  * 2025 SEP 15, v.1.10
  * 		Changed the DSPL::debugShow(). Now color of the fan speed is green
+ * 2026 OCT 16, v.1.13
+ * 		Added DSPL::debugISR()
+ * 		Added DSPL::debugAC()
+ * 		Added DSPL::debugTelemetry()
+ * 		Added DSPL::debugRefresh()
+ * 		DSPL::drawTemp(), DSPL::drawPower() and DSPL::drawValue() send the changed tiles of the bitmap only (see compose.h)
+ * 		DSPL::drawTemp() and DSPL::drawValue() draw the changed digits only from the digit atlas (see atlas.h)
+ * 		DSPL::pidShowGraph() draws the ring-indexed graph: the new sample redraws two graph columns only
+ * 		DSPL::clear() starts new frame of the retained scene if UI_RETAINED is defined (see scene.h)
  */
 
 #include <string.h>
@@ -246,9 +255,12 @@ void DSPL::init(bool ips) {
 	// Allocate Bitmap for temperature string (3 symbols)
 	setFont(big_dgt_font);
 	setFontScale(2);
+	atl_temp.build(*this);
 	uint16_t h	= getMaxCharHeight();
-	uint16_t w	= getStrWidth("000") + 2;
-	bm_temp		= BITMAP(w, h);
+	uint16_t w	= getStrWidth("000");
+	if (w < atl_temp.cellWidth() * 3)						// The readout should fit three atlas cells
+		w = atl_temp.cellWidth() * 3;
+	bm_temp		= BITMAP(w + 2, h);
 
 	// Allocate BITMAP for unit power gauge
 	bm_gauge = BITMAP(13, h);
@@ -271,6 +283,10 @@ void DSPL::init(bool ips) {
 
 void DSPL::rotate(tRotation rotation) {
 	setRotation(rotation);
+	SCENE::lose();											// The screen layout has been changed
+	comp.invalidate();
+	atl_temp.invalidate();
+	atl_value.invalidate();
 	update();												// Update the icons and symbols position on the screen depending on orientation
 }
 
@@ -284,18 +300,26 @@ void DSPL::setLetterFont(uint8_t *font) {
 
 	// Allocate Bitmap for preset temperature (3 symbols)
 	setFont(letter_font);
+	atl_value.build(*this);
 	uint16_t h	= getMaxCharHeight();
-	uint16_t w	= getStrWidth("000") + 2;
-	bm_preset	= BITMAP(w, h);
+	uint16_t w	= getStrWidth("000");
+	if (w < atl_value.cellWidth() * 3)						// The readout should fit three atlas cells
+		w = atl_value.cellWidth() * 3;
+	bm_preset	= BITMAP(w + 2, h);
 }
 
 void DSPL::clear(void) {
+	pwr_pcnt	= 255;
+	graph_valid	= false;
+	if (SCENE::begin()) return;								// The screen is kept, the stale nodes will be erased by commit()
 	// Do not turn-off backlight in the debug mode
 #ifndef DEBUG_ON
 	BRGT::off();											// Switch-off the display brightness
 #endif
-	pwr_pcnt	= 255;
 	fillScreen(bg_color);
+	comp.invalidate();
+	atl_temp.invalidate();
+	atl_value.invalidate();
 }
 
 void DSPL::drawTempSet(uint16_t temp, tUnitPos pos) {
@@ -330,17 +354,14 @@ void DSPL::drawTemp(uint16_t temp, tUnitPos pos, uint32_t color) {
 	if (temp >= 1000) temp = 999;
 	char b[6];
 	sprintf(b, "%d", temp);
-	setFont(big_dgt_font);
-	setFontScale(2);
-	bm_temp.clear();
-	strToBitmap(bm_temp, b, align_center);
 	uint16_t x = width() - bm_temp.width() - 20;			// Portrait display orientation
 	if (width() > height()) {								// Landscape display orientation
 		x = (width() - bm_temp.width()) >> 1;
 		x += 50;
 	}
 	uint16_t y = (pos == u_upper)?iron_temp_y:gun_temp_y;
-	drawBitmap(x, y, bm_temp, bg_color, (color <= 0xffff)?color:fg_color);
+	SCENE::paint(sc_widget, x, y, bm_temp.width(), atl_temp.height(), 0);	// The atlas draws the changed digits itself
+	atl_temp.draw(x, y, bm_temp.width(), b, align_center, bg_color, (color <= 0xffff)?color:fg_color);
 }
 
 void DSPL::animateTempCooling(uint16_t t, bool celsius, tUnitPos pos) {
@@ -417,6 +438,7 @@ void DSPL::drawAlternate(uint16_t t, bool active, tDevice dev_type) {
 	}
 	if (t == 0) {
 		drawFilledRect(x, iron_temp_y + bm_temp.height() + 8, bm_preset.width(), bm_preset.height(), bg_color);
+		damage(x, iron_temp_y + bm_temp.height() + 8, bm_preset.width(), bm_preset.height());
 	} else {
 		setFont(letter_font);
 		drawValue(t, x, iron_temp_y + bm_temp.height() + 8, align_center, active?YELLOW:BLUE);
@@ -439,7 +461,9 @@ void DSPL::drawPower(uint8_t p, tUnitPos pos) {
 	uint8_t p_height	= gauge(p, 3, max_h);				// Applied power triangle height
 	uint16_t y			= (pos == u_upper)?iron_temp_y:gun_temp_y;
 	bm_gauge.drawVGauge(p_height, false);					// Draw non-edged triangle
-	drawBitmap(width()-5-bm_gauge.width(), y, bm_gauge, bg_color, fg_color);
+	uint16_t x			= width()-5-bm_gauge.width();
+	SCENE::paint(sc_widget, x, y, bm_gauge.width(), bm_gauge.height(), 0);
+	comp.draw(x, y, bm_gauge, bg_color, fg_color);
 }
 
 /*
@@ -498,6 +522,7 @@ void DSPL::statusIcon(const uint8_t* icon, uint16_t bg_color, uint16_t fg_color,
 	uint16_t y  = (pos == u_upper)?0:gun_temp_y - 30;
 	drawIcon(width()-40, y, 28, 28, icon, 28, bg_color, fg_color);
 	drawFilledRect(width()-12, y, 12, 28, bg_color);		// Clear up the timeout area (see timeToOff())
+	damage(width()-40, y, 40, 28);							// The timeout readout should be drawn completely next time
 }
 
 void DSPL::msgOFF(tUnitPos pos) {
@@ -892,27 +917,34 @@ void DSPL::pidModify(uint8_t index, uint16_t value) {
 	uint8_t  o = getFontTopOffset();
 	drawFilledRect(x-10, y-o-10, w+20, h+20, bg_color);
 	drawStr(x, y, modified_value, fg_color);
+	graph_valid = false;									// The message is drawn over the graph
 }
 
+/*
+ * The graph is ring-indexed: the column of the pixmap is the position of the sample in the GRAPH ring buffer.
+ * The column 'col' shows the line between the samples at 'col' and 'col+1' positions, the column of the newest sample is empty.
+ * So the new sample changes two columns only: the column of the previous sample and the column of the new one.
+ * The whole graph is redrawn when the normalization of the graph has been changed or the screen has been changed.
+ */
 void DSPL::pidShowGraph(void) {
 	setFont(letter_font);
 	uint8_t h	= getMaxCharHeight() + 5;					// Extra space between lines
 	uint16_t top = h+30;
 
+	const uint16_t size		 = GRAPH::capacity();
+	const uint32_t n		 = GRAPH::count();
 	// Check both bitmaps allocated successfully
-	if (pm_graph.width() == 0) return;
+	if (pm_graph.width() == 0 || size == 0) return;
 	const uint16_t t_height  = pm_graph.height();			// The temperature graph height, leave 5 bottom lines free
-	const uint8_t  temp_zero = t_height/2;					// The temperature abscissa axis vertical coordinate inside bitmap
-    const uint8_t  disp_zero = t_height-1;					// The dispersion  abscissa axis vertical coordinate
 
 	// Calculate the transition coefficient for the temperature, dispersion and applied power
 	int16_t	 min_t = 32767;
 	int16_t  max_t = -32767;
 	uint16_t max_d = 0;										// Maximum value for dispersion
 	uint16_t till  = GRAPH::dataSize();
-	for (uint8_t i = 0; i < till; ++i) {
-		int16_t  t = GRAPH::temp(i);
-		uint16_t d = GRAPH::disp(i);
+	for (uint16_t i = 0; i < till; ++i) {
+		int16_t  t = GRAPH::tempAt(i);
+		uint16_t d = GRAPH::dispAt(i);
 		if (min_t > t) min_t = t;							// Here h_temp is average_temp - preset_temp
 		if (max_t < t) max_t = t;
 		if (max_d < d) max_d = d;
@@ -921,57 +953,86 @@ void DSPL::pidShowGraph(void) {
 	if (max_t < min_t)	max_t = min_t;						// normalize graph by its lower part
 	uint16_t d_height = t_height - h;						// Dispersion graph height is lower because we should write max dispersion value
 
-	// Normalize the graph data and fill-up the graph pixmap
-	pm_graph.clear();
-	int16_t g0[2]	= {0};									// Previous value of graph: temperature, dispersion
-	int16_t g1[2]	= {0};									// Current  value of graph: temperature, dispersion
-	for (uint16_t i = 0; i < till-1; ++i) {					// fill-up the graph bitmaps
-		// Normalize the data to be plotted. Current points are g1[x]
-		g0[0] = g1[0];										// Temperature graph. Save previous data
-		if (max_t == 0) {
-			g1[0] = temp_zero;
-		} else {
-			int16_t t = GRAPH::temp(i);
-			if (t > 0) {
-				g1[0] = temp_zero - round((float)t * (float)temp_zero / (float)max_t);
-				if (g1[0] < 1) g1[0] = 1;
-			} else {
-				int16_t neg = t * (-1);
-				g1[0] = temp_zero + round((float)neg * (float)temp_zero / (float)max_t);
-				if (g1[0] >= t_height) g1[0] = t_height - 1;
-			}
-		}
-		g0[1] = g1[1];										// Dispersion graph. Save previous data
-		if (max_d == 0) {
-			g1[1] = disp_zero;
-		} else {
-			int16_t d = round((float)GRAPH::disp(i) * (float)d_height / (float)max_d);
-			if (d >= d_height) d = d_height-1;
-			g1[1] = disp_zero - d;
-		}
-		// draw line between nearby points from t0 to t1, from d0 to d1, from p0 and p1
-		if (i > 0) {										// we need two points to draw the line
-			for (int8_t gr = 1; gr >= 0; --gr) {			// Through the graphs
-				uint16_t top_dot = g1[gr];					// draw vertical line from top_dot and length is len
-				uint16_t len = 0;
-				if (g1[gr] <= g0[gr]) {
-					len = g0[gr] - g1[gr] + 1;
-				} else {
-					top_dot = g0[gr];
-					len = g1[gr] - g0[gr] + 1;
-				}
-				pm_graph.drawVLineCode(i-1, top_dot, len, gr+2);
-			}
+	uint16_t x = bm_preset.width()+20;
+	SCENE::paint(sc_widget, x, top, pm_graph.width(), t_height, 0);	// The graph draws the changed columns itself
+	if (!graph_valid || max_t != graph_max_t || max_d != graph_max_d || n < graph_shown || n - graph_shown >= (size >> 1)) {
+		pm_graph.clear();
+		for (uint16_t col = 0; col < size; ++col)
+			pidGraphColumn(col, max_t, max_d, d_height);
+		drawPixmap(x, top, pm_graph.width(), t_height, pm_graph);
+	} else {												// Redraw the columns changed by the new samples
+		for (uint32_t k = graph_shown; k < n; ++k) {
+			uint16_t col  = k % size;
+			uint16_t prev = (col > 0)?col-1:size-1;
+			pidGraphColumn(prev, max_t, max_d, d_height);
+			pidGraphColumn(col,  max_t, max_d, d_height);
+			pm_graph.drawPart(x, top, prev, 0, 1, t_height);
+			pm_graph.drawPart(x, top, col,  0, 1, t_height);
 		}
 	}
-	pm_graph.drawHLineCode(0, temp_zero, pm_graph.width(), 1);	// Draw the temperature abscissa axis
-	drawPixmap(bm_preset.width()+20, top, pm_graph.width(), t_height, pm_graph);
+	graph_shown	= n;
+	graph_max_t	= max_t;
+	graph_max_d	= max_d;
+	graph_valid	= true;
 
 	// draw graph maximum value labels and applied power
 	drawValue(max_t, 0, top-h/2, align_right, gd_color);	// Show maximum value of temperature
 	drawValue(max_d, 0, top+h/2, align_right, dp_color);	// Show maximum value of dispersion
 }
 
+// Draw the graph column into pm_graph: the line between the samples at 'col' and 'col+1' ring buffer positions
+void DSPL::pidGraphColumn(uint16_t col, int16_t max_t, uint16_t max_d, uint16_t d_height) {
+	const uint16_t size		 = GRAPH::capacity();
+	const uint16_t t_height  = pm_graph.height();
+	const uint8_t  temp_zero = t_height/2;					// The temperature abscissa axis vertical coordinate inside bitmap
+    const uint8_t  disp_zero = t_height-1;					// The dispersion  abscissa axis vertical coordinate
+	if (col >= size || col >= pm_graph.width()) return;
+
+	pm_graph.drawVLineCode(col, 0, t_height, 0);			// Clear the column
+	uint16_t next	= (col+1 < size)?col+1:0;
+	uint32_t n		= GRAPH::count();
+	bool	 line	= (n < size)?((uint32_t)col + 1 < n):(col != (n-1) % size);	// Both samples exist and the next one is not the oldest
+	if (line) {
+		uint16_t pos[2] = {col, next};
+		int16_t  g[2][2];									// The normalized points: [sample][temperature, dispersion]
+		for (uint8_t s = 0; s < 2; ++s) {
+			if (max_t == 0) {
+				g[s][0] = temp_zero;
+			} else {
+				int16_t t = GRAPH::tempAt(pos[s]);
+				if (t > 0) {
+					g[s][0] = temp_zero - round((float)t * (float)temp_zero / (float)max_t);
+					if (g[s][0] < 1) g[s][0] = 1;
+				} else {
+					int16_t neg = t * (-1);
+					g[s][0] = temp_zero + round((float)neg * (float)temp_zero / (float)max_t);
+					if (g[s][0] >= t_height) g[s][0] = t_height - 1;
+				}
+			}
+			if (max_d == 0) {
+				g[s][1] = disp_zero;
+			} else {
+				int16_t d = round((float)GRAPH::dispAt(pos[s]) * (float)d_height / (float)max_d);
+				if (d >= d_height) d = d_height-1;
+				g[s][1] = disp_zero - d;
+			}
+		}
+		// draw line between nearby points
+		for (int8_t gr = 1; gr >= 0; --gr) {				// Through the graphs
+			uint16_t top_dot = g[1][gr];					// draw vertical line from top_dot and length is len
+			uint16_t len = 0;
+			if (g[1][gr] <= g[0][gr]) {
+				len = g[0][gr] - g[1][gr] + 1;
+			} else {
+				top_dot = g[0][gr];
+				len = g[1][gr] - g[0][gr] + 1;
+			}
+			pm_graph.drawVLineCode(col, top_dot, len, gr+2);
+		}
+	}
+	pm_graph.drawPixelCode(col, temp_zero, 1);				// The temperature abscissa axis
+}
+
 void DSPL::pidShowMenu(uint16_t pid_k[3], uint8_t index) {
 	static const uint8_t left  = 50;
 	char buff[12];
@@ -999,6 +1060,7 @@ void DSPL::pidShowMenu(uint16_t pid_k[3], uint8_t index) {
 void DSPL::pidShowMsg(const char *msg) {
 	setFont(letter_font);
 	drawStr(100, height()-50, msg, pid_color);
+	graph_valid = false;									// The message is drawn over the graph
 }
 
 void DSPL::pidShowInfo(uint16_t period, uint16_t loops) {
@@ -1015,6 +1077,9 @@ void DSPL::pidDestroyData(void) {
 void DSPL::errorMessage(t_msg_id err_id, uint16_t y) {
 	const char *err = NLS_MSG::msg(MSG_ERROR);
 	fillScreen(bg_color);
+	comp.invalidate();
+	atl_temp.invalidate();
+	atl_value.invalidate();
 	const char *msg = NLS_MSG::msg(err_id);
 	if (msg[0] == 0) {													// No error message specified, show big "ERROR"
 		setFont(letter_font);
@@ -1087,6 +1152,9 @@ void DSPL::showVersion(void) {
 	setFont(letter_font);
 	uint16_t h	= getMaxCharHeight() + 5;
 	fillScreen(bg_color);
+	comp.invalidate();
+	atl_temp.invalidate();
+	atl_value.invalidate();
 	// Show title
 	drawTitle(MSG_ABOUT);
 	// Show name
@@ -1159,6 +1227,56 @@ void DSPL::debugMessage(const char *msg, uint16_t x, uint16_t y, uint16_t len) {
 	drawStr(x, y+h, msg, fg_color);
 }
 
+// Show worst-case cycles of the temperature path IRQ handlers in the title area. Turn the value red when 3/4 of the window is used
+void DSPL::debugISR(uint32_t worst, uint32_t budget) {
+	char buff[24];
+	setFont(debug_font);
+	uint8_t h	= getMaxCharHeight();
+	BITMAP bm(width()-20, h);
+	sprintf(buff, "ISR %lu/%lu", worst, budget);
+	strToBitmap(bm, buff, align_center);
+	uint16_t clr = (worst * 4 > budget * 3)?gd_color:fg_color;
+	drawBitmap(10, 0, bm, bg_color, clr);
+}
+
+// Show AC line frequency, zero-cross jitter and the worst main loop task delay (ms) below the debug data. The value is green when TIM5 is aligned to the AC zero-cross
+void DSPL::debugAC(uint16_t freq, uint16_t jitter, bool locked, uint32_t late) {
+	char buff[32];
+	setFont(debug_font);
+	uint8_t  h		= getMaxCharHeight() + 5;							// The same line height as in DSPL::debugShow()
+	uint16_t top	= h+12;
+	BITMAP bm(width()-20, getMaxCharHeight());
+	sprintf(buff, "AC %2d.%02dHz j%d late %lu", freq / 100, freq % 100, jitter, late);
+	strToBitmap(bm, buff, align_center);
+	drawBitmap(10, top+7*h, bm, bg_color, locked?pr_color:fg_color);
+}
+
+// Show the telemetry of the iron below the AC line data: samples per second, average and maximum power, the raw temperature swing and the number of dropped samples
+void DSPL::debugTelemetry(uint16_t rate, uint16_t avg_power, uint16_t max_power, uint16_t ripple, uint32_t dropped) {
+	char buff[32];
+	setFont(debug_font);
+	uint8_t  h		= getMaxCharHeight() + 5;							// The same line height as in DSPL::debugShow()
+	uint16_t top	= h+12;
+	BITMAP bm(width()-20, getMaxCharHeight());
+	sprintf(buff, "TLM %d p%d/%d r%d d%lu", rate, avg_power, max_power, ripple, dropped);
+	strToBitmap(bm, buff, align_center);
+	drawBitmap(10, top+8*h, bm, bg_color, (dropped)?gd_color:fg_color);
+}
+
+// Show the display frames per second (multiplied by 10), the SPI bus utilization and the glyph cache hit rate below the telemetry data
+void DSPL::debugRefresh(uint16_t fps, uint8_t bus_load, uint32_t glyph_hits, uint32_t glyph_misses) {
+	char buff[32];
+	setFont(debug_font);
+	uint8_t  h		= getMaxCharHeight() + 5;							// The same line height as in DSPL::debugShow()
+	uint16_t top	= h+12;
+	BITMAP bm(width()-20, getMaxCharHeight());
+	uint32_t glyphs = glyph_hits + glyph_misses;
+	uint8_t  hit_rate = (glyphs > 0)?(uint64_t)glyph_hits * 100 / glyphs:0;
+	sprintf(buff, "FPS %d.%d bus %d%% gc %d%%", fps / 10, fps % 10, bus_load, hit_rate);
+	strToBitmap(bm, buff, align_center);
+	drawBitmap(10, top+9*h, bm, bg_color, fg_color);
+}
+
 void DSPL::checkBox(BITMAP &bm, uint16_t x, uint8_t size, bool checked) {
 	uint16_t w = bm.width();
 	uint8_t  h = bm.height();
@@ -1225,10 +1343,9 @@ void DSPL::drawValue(uint16_t value, uint16_t x, uint16_t y, BM_ALIGN align, uin
 	if (value > 999) value = 999;
 	char b[6];
 	sprintf(b, "%d", value);
-	setFont(letter_font);
-	bm_preset.clear();
-	strToBitmap(bm_preset, b, align);
-	drawBitmap(x, y, bm_preset, bg_color, color);
+	setFont(letter_font);									// The callers rely on the letter font to be selected
+	SCENE::paint(sc_widget, x, y, bm_preset.width(), atl_value.height(), 0);
+	atl_value.draw(x, y, bm_preset.width(), b, align, bg_color, color);
 }
 
 // Update icons and symbols coordinate
@@ -1246,3 +1363,120 @@ void DSPL::update(void) {
 		active_icon_y	= fan_icon_y;
 	}
 }
+
+// The screen area has been changed by other drawing routines, the widgets should be drawn completely
+void DSPL::damage(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	comp.invalidate(x, y, width, height);
+	atl_temp.invalidate(x, y, width, height);
+	atl_value.invalidate(x, y, width, height);
+}
+
+#ifdef UI_RETAINED
+//---------------------- The drawing primitives of the retained scene, see scene.h -------------------
+void DSPL::fillScreen(uint16_t color) {
+	tft::fillScreen(color);
+	SCENE::reset();											// The screen is empty
+}
+
+void DSPL::drawHLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+	if (!SCENE::paint(sc_fill, x, y, length, 1, SCENE::hash(&color, sizeof(color)))) return;
+	damage(x, y, length, 1);
+	tft::drawHLine(x, y, length, color);
+}
+
+void DSPL::drawVLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color) {
+	if (!SCENE::paint(sc_fill, x, y, 1, length, SCENE::hash(&color, sizeof(color)))) return;
+	damage(x, y, 1, length);
+	tft::drawVLine(x, y, length, color);
+}
+
+void DSPL::drawFilledRect(uint16_t x0, uint16_t y0, uint16_t width, uint16_t height, uint16_t color) {
+	if (!SCENE::paint(sc_fill, x0, y0, width, height, SCENE::hash(&color, sizeof(color)))) return;
+	damage(x0, y0, width, height);
+	tft::drawFilledRect(x0, y0, width, height, color);
+}
+
+// The circles and the round rectangle do not cover their area completely, so they are transparent
+void DSPL::drawCircle(uint16_t x, uint16_t y, uint8_t radius, uint16_t color) {
+	SCENE::paint(sc_fill, x-radius, y-radius, 2*radius+1, 2*radius+1, 0, false);
+	damage(x-radius, y-radius, 2*radius+1, 2*radius+1);
+	tft::drawCircle(x, y, radius, color);
+}
+
+void DSPL::drawFilledCircle(uint16_t x, uint16_t y, uint8_t radius, uint16_t color) {
+	SCENE::paint(sc_fill, x-radius, y-radius, 2*radius+1, 2*radius+1, 0, false);
+	damage(x-radius, y-radius, 2*radius+1, 2*radius+1);
+	tft::drawFilledCircle(x, y, radius, color);
+}
+
+void DSPL::drawRoundRect(uint16_t x, uint16_t y, uint16_t w, uint16_t h, uint16_t r, uint16_t color) {
+	SCENE::paint(sc_fill, x, y, w, h, 0, false);
+	damage(x, y, w, h);
+	tft::drawRoundRect(x, y, w, h, r, color);
+}
+
+void DSPL::drawFilledTriangle(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2, uint16_t color) {
+	uint16_t x = x0, y = y0, x_max = x0, y_max = y0;		// The bounding box of the triangle
+	if (x1 < x)		x = x1;
+	if (x2 < x)		x = x2;
+	if (y1 < y)		y = y1;
+	if (y2 < y)		y = y2;
+	if (x1 > x_max)	x_max = x1;
+	if (x2 > x_max)	x_max = x2;
+	if (y1 > y_max)	y_max = y1;
+	if (y2 > y_max)	y_max = y2;
+	uint16_t w = x_max - x + 1;
+	uint16_t h = y_max - y + 1;
+	SCENE::paint(sc_fill, x, y, w, h, 0, false);
+	damage(x, y, w, h);
+	tft::drawFilledTriangle(x0, y0, x1, y1, x2, y2, color);
+}
+
+void DSPL::drawIcon(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height, const uint8_t *bitmap, uint16_t bm_width, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t colors[2]	= {bg_color, fg_color};
+	uint32_t sig		= SCENE::hash(bitmap, ((bm_width + 7) >> 3) * area_height);
+	if (!SCENE::paint(sc_icon, x0, y0, area_width, area_height, SCENE::hash(colors, sizeof(colors), sig))) return;
+	damage(x0, y0, area_width, area_height);
+	tft::drawIcon(x0, y0, area_width, area_height, bitmap, bm_width, bg_color, fg_color);
+}
+
+void DSPL::drawBitmapArea(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height, BITMAP& bm, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t colors[3]	= {bg_color, fg_color, bm.width()};
+	uint32_t sig		= SCENE::hash(bm.bitmap(), ((bm.width() + 7) >> 3) * ((area_height < bm.height())?area_height:bm.height()));
+	if (!SCENE::paint(sc_bitmap, x0, y0, area_width, area_height, SCENE::hash(colors, sizeof(colors), sig))) return;
+	damage(x0, y0, area_width, area_height);
+	tft::drawBitmapArea(x0, y0, area_width, area_height, bm, bg_color, fg_color);
+}
+
+void DSPL::drawBitmap(uint16_t x0, uint16_t y0, BITMAP& bm, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t colors[2]	= {bg_color, fg_color};
+	uint32_t sig		= SCENE::hash(bm.bitmap(), ((bm.width() + 7) >> 3) * bm.height());
+	if (!SCENE::paint(sc_bitmap, x0, y0, bm.width(), bm.height(), SCENE::hash(colors, sizeof(colors), sig))) return;
+	damage(x0, y0, bm.width(), bm.height());
+	tft::drawBitmap(x0, y0, bm, bg_color, fg_color);
+}
+
+// The text is drawn on the baseline, the area is from the highest glyph top to the lowest glyph bottom
+u8g2_uint_t DSPL::drawStr(u8g2_uint_t x, u8g2_uint_t y, const char *str, uint16_t color) {
+	uint16_t w	= getStrWidth(str);
+	int16_t  h	= getMaxCharHeight();
+	int16_t  d	= getFontHeight() - h;						// Descent
+	SCENE::paint(sc_text, x, y-h, w, h+d, 0, false);
+	damage(x, y-h, w, h+d);
+	return tft::drawStr(x, y, str, color);
+}
+
+u8g2_uint_t DSPL::drawUTF8(u8g2_uint_t x, u8g2_uint_t y, const char *str, uint16_t color) {
+	uint16_t w	= getUTF8Width(str);
+	int16_t  h	= getMaxCharHeight();
+	int16_t  d	= getFontHeight() - h;						// Descent
+	SCENE::paint(sc_text, x, y-h, w, h+d, 0, false);
+	damage(x, y-h, w, h+d);
+	return tft::drawUTF8(x, y, str, color);
+}
+
+void DSPL::eraseArea(uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+	tft::drawFilledRect(x, y, width, height, bg_color);
+	damage(x, y, width, height);
+}
+#endif
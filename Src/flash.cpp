@@ -9,6 +9,15 @@
  *	2025 NOV 04, 1.1.12
  *		Fixing issue of deactivating TIP
  *  	Changed W25Q::saveTipData() to reopen TIPS calibration file, tipcal.dat, for write access
+ *	2026 OCT 16, v.1.13
+ *		The TIP record includes the tip thermal model fields now. Added W25Q::countTips() and W25Q::upgradeTips()
+ *		to convert the old tipcal.dat file format in W25Q::init()
+ *		The tipcal.dat file starts with the header, so the file format is known. Added W25Q::checkTipFile() to convert
+ *		the old file format at startup and after the file has been loaded from the SD-CARD
+ *		The records are saved to the record journal (see journal.h) if the FatFS volume does not occupy the reserved sectors,
+ *		the configuration files are the export view of the journal now (see W25Q::exportJournal())
+ *		Added the tip record cache, so the tip records in use are loaded from the flash once
+ *		Added the hint parameter to W25Q::saveTipData(): the known tip record index, to avoid the tip record lookup
  */
 #include <string.h>
 #include "flash.h"
@@ -20,13 +29,72 @@ FLASH_STATUS W25Q::init(void) {
 	if (!W25Qxx_Init()) return FLASH_ERROR;
 	if (!mount())		return FLASH_NO_FILESYSTEM;
 
-	uint16_t	good_tips = 0;
-	if (FR_OK == f_open(&cfg_f, fn_tip_calib, FA_READ)) {	// Check the tip calibration data
+	uint16_t n			= W25Qxx_SectorCount();
+	uint32_t fat_end	= fs.database + (fs.n_fatent - 2) * fs.csize;	// The sector next to the last cluster of the volume
+	if (n > W25Qxx_RESERVED && fat_end <= (uint32_t)(n - W25Qxx_RESERVED))
+		jrnl.init(n - W25Qxx_RESERVED, W25Qxx_RESERVED);	// The flash was formatted with the reserved sectors
+	checkTipFile();
+	return FLASH_OK;
+}
+
+/*
+ * Check the tip calibration file. Restore the file from the backup if there is no correct tip record in it.
+ * Convert the file of old format. Called at startup and when the file has been loaded from the SD-CARD. The flash remains mounted
+ */
+void W25Q::checkTipFile(void) {
+	if (!mount())
+		return;
+	W25Q::close();
+	dropTipCache();
+	TIP_FILE_FMT fmt = tipFileFormat();
+	if (countTips(fmt) == 0) {								// Not tip loaded, try the backup file
+		FILINFO fno;
+		if (FR_OK == f_stat(fn_tip_backup, &fno)) {			// There is the backup file exists
+			f_unlink(fn_tip_calib);
+			f_rename(fn_tip_backup, fn_tip_calib);
+			fmt = tipFileFormat();
+		}
+	}
+	if (fmt == TIP_FILE_OLD && upgradeTips() && jrnl.isActive())
+		jrnl.clear(jr_tip);									// The journal tip records do not belong to the converted file
+}
+
+/*
+ * The tip calibration file of the current format starts with the header, tip_magic.
+ * The old file is the sequence of 16-bytes records. The first bytes of the old file are the internal temperature of the tip
+ * reference point, less than 4096, so the old file cannot start with the header
+ */
+TIP_FILE_FMT W25Q::tipFileFormat(void) {
+	TIP_FILE_FMT fmt = TIP_FILE_NONE;
+	if (FR_OK == f_open(&cfg_f, fn_tip_calib, FA_READ)) {
+		uint32_t	magic	= 0;
+		UINT		br		= 0;
+		f_read(&cfg_f, (void *)&magic, sizeof(magic), &br);
+		if (br == sizeof(magic) && magic == tip_magic) {
+			fmt = TIP_FILE_CURRENT;
+		} else if (f_size(&cfg_f) > 0 && f_size(&cfg_f) % tip_v1_size == 0) {
+			fmt = TIP_FILE_OLD;
+		}
+		f_close(&cfg_f);
+	}
+	return fmt;
+}
+
+// Count the tip records with correct CRC in the tip calibration file. The record size is different in the old file format
+uint16_t W25Q::countTips(TIP_FILE_FMT fmt) {
+	if (fmt == TIP_FILE_NONE)
+		return 0;
+	UINT		rec_size	= (fmt == TIP_FILE_OLD)?tip_v1_size:(UINT)sizeof(TIP);
+	uint16_t	good_tips	= 0;
+	if (FR_OK == f_open(&cfg_f, fn_tip_calib, FA_READ)) {
+		if (fmt == TIP_FILE_CURRENT)
+			f_lseek(&cfg_f, tipOffset(0));					// Skip the file header
 		while (true) {										// Read all tip calibration data
 			UINT	br = 0;
 			TIP		tmp_tip;
-			f_read(&cfg_f, (void *)&tmp_tip, (UINT)sizeof(TIP), &br);
-			if (br ==  (UINT)sizeof(TIP)) {
+			memset((void *)&tmp_tip, 0, sizeof(TIP));		// The old record has no tip model fields
+			f_read(&cfg_f, (void *)&tmp_tip, rec_size, &br);
+			if (br == rec_size) {
 				if (TIP_checkSum(&tmp_tip, false)) {		// CRC of the tip record is correct
 					++good_tips;
 				}
@@ -36,14 +104,44 @@ FLASH_STATUS W25Q::init(void) {
 		}
 		f_close(&cfg_f);
 	}
-	if (good_tips == 0) {									// Not tip loaded, try the backup file
-		FILINFO fno;
-		if (FR_OK == f_stat(fn_tip_backup, &fno)) {			// There is the backup file exists
-			f_unlink(fn_tip_calib);
-			f_rename(fn_tip_backup, fn_tip_calib);
+	return good_tips;
+}
+
+/*
+ * Convert the tip calibration file of 16-bytes records (before v.1.13) into the current format through the backup file.
+ * The header is written first. The records order is kept. The tip model fields are zero, so the CRC of the old record remains correct
+ */
+bool W25Q::upgradeTips(void) {
+	FIL out_f;
+	if (FR_OK != f_open(&cfg_f, fn_tip_calib, FA_READ))
+		return false;
+	if (FR_OK != f_open(&out_f, fn_tip_backup, FA_CREATE_ALWAYS | FA_WRITE)) {
+		f_close(&cfg_f);
+		return false;
+	}
+	UINT	written = 0;
+	f_write(&out_f, (void *)&tip_magic, sizeof(tip_magic), &written);
+	bool ret = (written == sizeof(tip_magic));
+	while (ret) {
+		UINT	br = 0;
+		TIP		tmp_tip;
+		memset((void *)&tmp_tip, 0, sizeof(TIP));
+		f_read(&cfg_f, (void *)&tmp_tip, tip_v1_size, &br);
+		if (br != tip_v1_size)								// File is over
+			break;
+		f_write(&out_f, (void *)&tmp_tip, sizeof(TIP), &written);
+		if (written != sizeof(TIP)) {
+			ret = false;
+			break;
 		}
 	}
-	return FLASH_OK;
+	f_close(&cfg_f);
+	f_close(&out_f);
+	if (ret) {
+		f_unlink(fn_tip_calib);
+		f_rename(fn_tip_backup, fn_tip_calib);
+	}
+	return ret;
 }
 
 bool W25Q::reset() {
@@ -88,12 +186,16 @@ void W25Q::close(void) {
 }
 
 bool W25Q::loadRecord(RECORD* config_record) {
+	RECORD tmp_record;
+	if (jrnl.load(jr_config, 0, &tmp_record, sizeof(RECORD)) && CFG_checkSum(&tmp_record, false)) {
+		memcpy((void *)config_record, (void *)&tmp_record, sizeof(RECORD));
+		return true;
+	}
 	if (!mount())
 		return false;
 	W25Q::close();
 	UINT br = 0;
 	bool ret = false;
-	RECORD tmp_record;
 	if (FR_OK == f_open(&cfg_f, fn_cfg, FA_READ | FA_OPEN_EXISTING)) {
 		f_read(&cfg_f, (void *)&tmp_record, (UINT)sizeof(RECORD), &br);
 		if (br ==  (UINT)sizeof(RECORD)) {
@@ -127,29 +229,29 @@ bool W25Q::loadRecord(RECORD* config_record) {
 }
 
 bool W25Q::saveRecord(RECORD* config_record) {
+	CFG_checkSum(config_record, true);
+	if (jrnl.save(jr_config, 0, config_record, sizeof(RECORD)))
+		return true;										// The config.dat file is updated by exportJournal()
 	if (!mount())
 		return false;
 	W25Q::close();
 	backup(W25Q_CONFIG_CURRENT);
-	CFG_checkSum(config_record, true);
-	bool ret = false;
-	if (FR_OK == f_open(&cfg_f, fn_cfg, FA_CREATE_ALWAYS | FA_WRITE)) {
-		UINT written = 0;
-		f_write(&cfg_f, (void *)config_record, sizeof(RECORD), &written);
-		ret = (written == sizeof(RECORD));
-		f_close(&cfg_f);
-	}
+	bool ret = writeFile(fn_cfg, (void *)config_record, sizeof(RECORD));
 	umount();
 	return ret;
 }
 
 bool W25Q::loadPIDparams(PID_PARAMS* pid_params) {
+	PID_PARAMS tmp_record;
+	if (jrnl.load(jr_pid, 0, &tmp_record, sizeof(PID_PARAMS)) && PID_checkSum(&tmp_record, false)) {
+		memcpy((void *)pid_params, (void *)&tmp_record, sizeof(PID_PARAMS));
+		return true;
+	}
 	if (!mount())
 		return false;
 	W25Q::close();
 	UINT br = 0;
 	bool ret = false;
-	PID_PARAMS tmp_record;
 	if (FR_OK == f_open(&cfg_f, fn_pid, FA_READ | FA_OPEN_EXISTING)) {
 		f_read(&cfg_f, (void *)&tmp_record, (UINT)sizeof(PID_PARAMS), &br);
 		if (br ==  (UINT)sizeof(PID_PARAMS)) {
@@ -165,10 +267,12 @@ bool W25Q::loadPIDparams(PID_PARAMS* pid_params) {
 }
 
 bool W25Q::savePIDparams(PID_PARAMS* pid_params) {
+	PID_checkSum(pid_params, true);
+	if (jrnl.save(jr_pid, 0, pid_params, sizeof(PID_PARAMS)))
+		return true;										// The pid.dat file is updated by exportJournal()
 	if (!mount())
 		return false;
 	W25Q::close();
-	PID_checkSum(pid_params, true);
 	bool ret = false;
 	if (FR_OK == f_open(&cfg_f, fn_pid, FA_CREATE_ALWAYS | FA_WRITE)) {
 		UINT written = 0;
@@ -180,8 +284,18 @@ bool W25Q::savePIDparams(PID_PARAMS* pid_params) {
 	return ret;
 }
 
-// Load tip configuration data from file
+// Load tip configuration data from the journal or from the file
 TIP_IO_STATUS W25Q::loadTipData(TIP* tip, uint8_t tip_index, bool keep) {
+	if (cachedTip(tip, tip_index))
+		return returnStatus(keep, TIP_OK);
+	TIP		tmp_tip;
+	if (jrnl.load(jr_tip, tip_index, &tmp_tip, sizeof(TIP))) {	// The journal has the actual tip record
+		if (!TIP_checkSum(&tmp_tip, false))
+			return returnStatus(keep, TIP_CHECKSUM);
+		memcpy((void *)tip, (const void *)&tmp_tip, sizeof(TIP));
+		cacheTip(tip, tip_index);
+		return returnStatus(keep, TIP_OK);
+	}
 	if (!mount())											// Cannot mount W25Qxx flash
 		return TIP_IO;
 	if (act_f != W25Q_TIPS_CURRENT) {						// Close other configuration file
@@ -194,16 +308,16 @@ TIP_IO_STATUS W25Q::loadTipData(TIP* tip, uint8_t tip_index, bool keep) {
 	if (act_f != W25Q_TIPS_CURRENT)
 		return returnStatus(keep, TIP_IO);
 
-	if (FR_OK != f_lseek(&cfg_f, tip_index * sizeof(TIP))) { // Invalid tip index
+	if (FR_OK != f_lseek(&cfg_f, tipOffset(tip_index))) {	// Invalid tip index
 		return returnStatus(keep, TIP_INDEX);
 	}
 	// Read tip calibration data
 	UINT	br = 0;
-	TIP		tmp_tip;
 	f_read(&cfg_f, (void *)&tmp_tip, (UINT)sizeof(TIP), &br);
 	if (br == (UINT)sizeof(TIP)) {
 		if (TIP_checkSum(&tmp_tip, false)) {				// CRC of the tip record is correct
 			memcpy((void *)tip, (const void *)&tmp_tip, sizeof(TIP)); // Copy the tip record from the data buffer
+			cacheTip(tip, tip_index);
 			return returnStatus(keep, TIP_OK);
 		}
 		return returnStatus(keep, TIP_CHECKSUM);
@@ -211,13 +325,26 @@ TIP_IO_STATUS W25Q::loadTipData(TIP* tip, uint8_t tip_index, bool keep) {
 	return returnStatus(keep, TIP_IO);
 }
 
-// Return tip index in the file or -1 if error
-int16_t W25Q::saveTipData(TIP* tip, bool keep) {
+/*
+ * Return tip index in the file or -1 if error
+ * hint is the tip record index known by the caller (see CFG::buildTipTable()) or -1 if the tip record should be found by name
+ */
+int16_t W25Q::saveTipData(TIP* tip, bool keep, int16_t hint) {
+	if (jrnl.isActive()) {
+		int16_t tip_index = (hint >= 0)?hint:findTip(tip->name);
+		TIP_checkSum(tip, true);
+		if (tip_index < JRNL_TIPS && jrnl.save(jr_tip, tip_index, tip, sizeof(TIP))) {
+			cacheTip(tip, tip_index);
+			if (!keep)
+				W25Q::umount();
+			return tip_index;								// The tipcal.dat file is updated by exportJournal()
+		}
+	}
 	if (!mount())
 		return -1;
 	bool new_entry = false;
 	if (act_f == W25Q_TIPS_CURRENT && rw) {					// The tip configuration file is already opened and write enabled
-		f_lseek(&cfg_f, 0);									// Rewind to the top of the file
+		f_lseek(&cfg_f, tipOffset(0));						// Rewind to the first tip record
 	} else {
 		W25Q::close();
 		backup(W25Q_TIPS_CURRENT);
@@ -231,11 +358,30 @@ int16_t W25Q::saveTipData(TIP* tip, bool keep) {
 		}
 		act_f 	= W25Q_TIPS_CURRENT;
 		rw		= true;										// File open for read/write
+		if (f_size(&cfg_f) == 0) {							// Empty file, write the header first
+			UINT	written = 0;
+			f_write(&cfg_f, (void *)&tip_magic, sizeof(tip_magic), &written);
+			if (written != sizeof(tip_magic)) {
+				W25Q::close();
+				return -1;
+			}
+			new_entry = true;
+		}
 	}
 	if (!new_entry) {										// Try to locate our tip in the file
 		UINT	br = 0;										// Bytes actually read from the file
 		TIP		tmp_tip;
-		while(true) {										// Looking for the tip
+		bool	found = false;
+		if (hint >= 0 && FR_OK == f_lseek(&cfg_f, tipOffset(hint))) {	// Check the tip record at the known index first
+			f_read(&cfg_f, (void *)&tmp_tip, (UINT)sizeof(TIP), &br);
+			if (br == (UINT)sizeof(TIP) && strncmp(tip->name, tmp_tip.name, tip_name_sz) == 0) {
+				f_lseek(&cfg_f, cfg_f.fptr-sizeof(TIP));
+				found = true;
+			}
+		}
+		if (!found)
+			f_lseek(&cfg_f, tipOffset(0));					// Look for the tip from the first record
+		while(!found) {										// Looking for the tip
 			f_read(&cfg_f, (void *)&tmp_tip, (UINT)sizeof(TIP), &br);
 			if (br == (UINT)sizeof(TIP)) {
 				if (strncmp(tip->name, tmp_tip.name, tip_name_sz) == 0) {
@@ -248,12 +394,16 @@ int16_t W25Q::saveTipData(TIP* tip, bool keep) {
 		}
 	}
 	// Update or add new tip information
-	int16_t tip_index = cfg_f.fptr / sizeof(TIP);
+	int16_t tip_index = (cfg_f.fptr - tipOffset(0)) / sizeof(TIP);
 	TIP_checkSum(tip, true);								// calculate CRC inside the data buffer
 	UINT	written = 0;
 	f_write(&cfg_f, (void *)tip, sizeof(TIP), &written);
-	if (written != sizeof(TIP))
+	if (written != sizeof(TIP)) {
 		tip_index = -1;
+		dropTipCache();										// The tip record in the file is unknown now
+	} else {
+		cacheTip(tip, tip_index);
+	}
 	if (!keep) {
 		f_close(&cfg_f);									// Close file for sure
 		W25Q::umount();
@@ -274,6 +424,12 @@ bool W25Q::formatFlashDrive(void) {
 		return false;
 	bool ret = (FR_OK == f_mkfs("0:/", &p, buff, blk_size));
 	free(buff);
+	dropTipCache();
+	if (ret) {												// The new volume does not occupy the reserved sectors, start new journal
+		uint16_t n = W25Qxx_SectorCount();
+		if (n > W25Qxx_RESERVED)
+			jrnl.format(n - W25Qxx_RESERVED, W25Qxx_RESERVED);
+	}
 	return ret;
 }
 
@@ -283,6 +439,9 @@ bool W25Q::clearTips(void) {
 	f_unlink(fn_tip_calib);
 	f_unlink(fn_tip_backup);
 	umount();
+	dropTipCache();
+	if (jrnl.isActive())
+		jrnl.clear(jr_tip);
 	return true;
 }
 
@@ -292,6 +451,8 @@ bool W25Q::clearConfig(void) {
 		f_unlink(fn_cfg);
 		f_unlink(fn_cfg_backup);
 		umount();
+		if (jrnl.isActive())
+			jrnl.clear(jr_config);
 		return true;
 	}
 	return false;
@@ -323,6 +484,121 @@ const TCHAR*	W25Q::fileName(uint8_t index) {
 	return 0;
 }
 
+// Write the actual journal records into the configuration files, so the files can be copied to the SD-card
+bool W25Q::exportJournal(void) {
+	if (!jrnl.isActive())
+		return true;										// The configuration files are actual
+	if (!mount())
+		return false;
+	W25Q::close();
+	bool ret = true;
+	RECORD cfg;
+	if (jrnl.load(jr_config, 0, &cfg, sizeof(RECORD)))
+		ret = writeFile(fn_cfg, (void *)&cfg, sizeof(RECORD));
+	PID_PARAMS pid;
+	if (jrnl.load(jr_pid, 0, &pid, sizeof(PID_PARAMS)))
+		ret &= writeFile(fn_pid, (void *)&pid, sizeof(PID_PARAMS));
+	uint16_t slots = jrnl.tipSlots();
+	if (slots > 0) {
+		if (FR_OK == f_open(&cfg_f, fn_tip_calib, FA_OPEN_ALWAYS | FA_WRITE)) {
+			bool tip_ok = true;
+			if (f_size(&cfg_f) == 0) {						// New file, write the header first
+				UINT written = 0;
+				f_write(&cfg_f, (void *)&tip_magic, sizeof(tip_magic), &written);
+				tip_ok = (written == sizeof(tip_magic));
+			}
+			for (uint16_t i = 0; tip_ok && i < slots; ++i) {
+				TIP tip;
+				if (!jrnl.load(jr_tip, i, &tip, sizeof(TIP))) {
+					if (tipOffset(i) + sizeof(TIP) <= f_size(&cfg_f))
+						continue;							// The record in the file is actual
+					memset((void *)&tip, 0, sizeof(TIP));	// No record for the slot beyond the end of file, write the empty one with wrong CRC
+				}
+				UINT written = 0;
+				if (FR_OK != f_lseek(&cfg_f, tipOffset(i)) || FR_OK != f_write(&cfg_f, (void *)&tip, sizeof(TIP), &written)
+						|| written != sizeof(TIP)) {
+					tip_ok = false;
+				}
+			}
+			ret &= tip_ok;
+			f_close(&cfg_f);
+		} else {
+			ret = false;
+		}
+	}
+	umount();
+	return ret;
+}
+
+bool W25Q::dropJournal(void) {
+	dropTipCache();											// The tip records are loaded from the file now
+	uint16_t n = W25Qxx_SectorCount();
+	if (!jrnl.isActive() || n <= W25Qxx_RESERVED)
+		return false;
+	return jrnl.format(n - W25Qxx_RESERVED, W25Qxx_RESERVED);
+}
+
+// Find the tip record by name in the journal and in the tip calibration file. Return the index of the new record if the tip is not found
+int16_t W25Q::findTip(const char *name) {
+	TIP		tmp_tip;
+	int16_t	i = 0;
+	for ( ; i < JRNL_TIPS; ++i) {
+		TIP_IO_STATUS ts = loadTipData(&tmp_tip, i, true);
+		if (ts == TIP_IO || ts == TIP_INDEX)				// No more records
+			break;
+		if (ts == TIP_OK && strncmp(name, tmp_tip.name, tip_name_sz) == 0)
+			break;
+	}
+	return i;
+}
+
+bool W25Q::writeFile(const TCHAR *fn, void *data, UINT size) {
+	bool ret = false;
+	if (FR_OK == f_open(&cfg_f, fn, FA_CREATE_ALWAYS | FA_WRITE)) {
+		UINT written = 0;
+		f_write(&cfg_f, data, size, &written);
+		ret = (written == size);
+		f_close(&cfg_f);
+	}
+	return ret;
+}
+
+bool W25Q::cachedTip(TIP* tip, uint8_t tip_index) {
+	for (uint8_t i = 0; i < W25Q_TIP_CACHE; ++i) {
+		if (cache_used[i] && cache_index[i] == tip_index) {
+			if (!TIP_checkSum(&tip_cache[i], false)) {		// The cached record is corrupted, load it from the flash
+				cache_used[i] = 0;
+				return false;
+			}
+			memcpy((void *)tip, (const void *)&tip_cache[i], sizeof(TIP));
+			cache_used[i] = ++cache_cnt;
+			return true;
+		}
+	}
+	return false;
+}
+
+// Put the tip record into the cache. Replace the cached record with the same index or the least recently used one
+void W25Q::cacheTip(const TIP* tip, uint8_t tip_index) {
+	uint8_t e = 0;
+	for (uint8_t i = 0; i < W25Q_TIP_CACHE; ++i) {
+		if (cache_used[i] && cache_index[i] == tip_index) {
+			e = i;
+			break;
+		}
+		if (cache_used[i] < cache_used[e])
+			e = i;
+	}
+	memcpy((void *)&tip_cache[e], (const void *)tip, sizeof(TIP));
+	cache_index[e]	= tip_index;
+	cache_used[e]	= ++cache_cnt;
+}
+
+void W25Q::dropTipCache(void) {
+	for (uint8_t i = 0; i < W25Q_TIP_CACHE; ++i)
+		cache_used[i] = 0;
+}
+
 TIP_IO_STATUS W25Q::returnStatus(bool keep, TIP_IO_STATUS ret_code) {
 	if (!keep) {
 		f_close(&cfg_f);
@@ -342,6 +618,10 @@ uint8_t W25Q::TIP_checkSum(TIP* tip, bool write) {
 	for (int i = 0; i < tip_name_sz; ++i) {
 		summ <<= 1; summ += (uint8_t)tip->name[i];
 	}
+	if (tip->heat_cap || tip->heat_loss) {					// Keep the CRC of the old records without tip model
+		summ <<= 1; summ += tip->heat_cap;
+		summ <<= 1; summ += tip->heat_loss;
+	}
 	summ += 117;											// To avoid good check sum with all-zero
 	uint8_t res = (tip->crc == (summ & 0xFF));
 	if (write) tip->crc = summ & 0xFF;
@@ -387,9 +667,9 @@ bool W25Q::backup(ACT_FILE type) {
 	if (type == W25Q_TIPS_CURRENT) {
 		FILINFO fno;
 		if (FR_OK == f_stat(fn_tip_calib, &fno)) {
-			f_size = fno.fsize;								// Ensure the file size is multiple of TIP size
-			uint16_t tips = f_size / sizeof(TIP);
-			f_size = tips * sizeof(TIPS);
+			f_size = fno.fsize;								// Ensure the file holds the header and the whole TIP records
+			uint16_t tips = (f_size > tipOffset(0))?(f_size - tipOffset(0)) / sizeof(TIP):0;
+			f_size = tipOffset(tips);
 		}
 	}
 
@@ -1,6 +1,10 @@
 /*
  * graph.cpp
  *
+ * 2026 OCT 16, v.1.13
+ *  	GRAPH::freeData() marks the data as not allocated, so GRAPH::allocate() does not use the freed buffers
+ *  	GRAPH::allocate() reallocates the buffers when the graph size changes, so the graph size always matches the requested one
+ *  	The ring buffer index is 16-bits wide now, the graph can be longer than 255 samples
  */
 
 #include <stdlib.h>
@@ -10,7 +14,8 @@
 bool GRAPH::allocate(uint16_t size) {
 	data_index	= 0;
 	full_buff	= false;
-	if (this->size > 0 && this->size < size) {
+	total		= 0;
+	if (this->size > 0 && this->size != size) {
 		free(h_temp);
 		free(h_disp);
 		this->size = 0;
@@ -36,11 +41,14 @@ void GRAPH::freeData(void) {
 		free(h_temp);
 		free(h_disp);
 	}
+	h_temp	= 0;
+	h_disp	= 0;
+	size	= 0;
 }
 
 void GRAPH::put(int16_t t, uint16_t d) {
 	if (size == 0) return;
-	uint8_t	i 	= data_index;
+	uint16_t i 	= data_index;
 	t 	= constrain(t, -500, 500);										// Limit graph value
 	d	= constrain(d,    0, 999);
 
@@ -51,6 +59,7 @@ void GRAPH::put(int16_t t, uint16_t d) {
 		full_buff = true;
 	}
 	data_index	= i;
+	++total;
 }
 
 int16_t	GRAPH::temp(uint16_t index) {
@@ -29,6 +29,10 @@
  *		and save the time when this temperature was reached. In case the minimal temperature has not been changed in HOTGUN::cooling_to time,
  *		assume the Hot Air Gun has been cooled, give a little timeout and shutdown the unit.
  *		Modified the HOTGUN::switchPower() and HOTGUN::power() to implement new cooling method.
+ * 2026 OCT 16, v.1.13
+ * 		The PID denominator power is the HOTGUN::pid_q template parameter, the PID output is limited by max_power
+ * 		HOTGUN::power() calculates the power with GUN_POWER_Q fractional bits (fine_power). In sigma-delta mode the PID output
+ * 		is not rounded to the whole AC half-periods, the sigma-delta modulator applies the fractional part (see core.cpp)
  *
  */
 
@@ -50,7 +54,7 @@ void HOTGUN::init(void) {
 	h_temp.reset();
 	d_power.length(ec);
 	d_temp.length(ec);
-	PID::init(1200, 13, false);								// Initialize PID for Hot Air Gun, 1Hz. Do not forcible heat!
+	PID::init<pid_q>(1200, max_power, false);				// Initialize PID for Hot Air Gun, 1Hz. Do not forcible heat!
     resetPID();
 }
 
@@ -235,6 +239,16 @@ void HOTGUN::fixPower(uint16_t Power) {
 }
 
 
+// The PID output keeps the fractional part in sigma-delta mode only. The power pattern applies whole AC half-periods
+int32_t HOTGUN::pidPower(int16_t t_set, int16_t t) {
+	if (sigma_delta) {
+		int32_t p = PID::reqPower<pid_q - GUN_POWER_Q>(t_set, t);
+		return constrain(p, 0, max_power << GUN_POWER_Q);
+	}
+	int32_t p = PID::reqPower<pid_q>(t_set, t);
+	return constrain(p, 0, max_power) << GUN_POWER_Q;
+}
+
 // Called by event handlers every 1.2 seconds (see core.cpp)
 uint16_t HOTGUN::power(void) {
 	uint16_t t = c_temp.read();								// Actual Hot Air Gun temperature
@@ -244,7 +258,7 @@ uint16_t HOTGUN::power(void) {
 		if (mode == POWER_ON) chill = true;					// Turn off the power in main working mode only;
 	}
 
-	int32_t	p = 0;											// The Hot Air Gun power value
+	int32_t	p = 0;											// The Hot Air Gun power value, GUN_POWER_Q
 	switch (mode) {
 		case POWER_OFF:
 			break;
@@ -271,8 +285,7 @@ uint16_t HOTGUN::power(void) {
 					--relay_ready_cnt;						// Do not apply power to the HOT GUN till AC relay is ready
 					relay_ready_cnt &= 7;
 				} else {
-					p = PID::reqPower(temp_set, t);
-					p = constrain(p, 0, max_power);
+					p = pidPower(temp_set, t);
 				}
 			}
 			break;
@@ -280,7 +293,7 @@ uint16_t HOTGUN::power(void) {
 			if (relay_ready_cnt > 0) {						// Relay is not ready yet
 				--relay_ready_cnt;							// Do not apply power to the HOT GUN till AC relay is ready
 			} else {
-				p = fix_power;
+				p = fix_power << GUN_POWER_Q;
 			}
 			FAN_TIM.Instance->CCR1	= fan_speed;
 			break;
@@ -294,8 +307,7 @@ uint16_t HOTGUN::power(void) {
 					break;
 				}
 			}
-			p = PID::reqPower(low_temp, t);
-			p = constrain(p, 0, max_power);
+			p = pidPower(low_temp, t);
 			break;
 		case POWER_COOLING:
 			if (fanSpeed() < min_fan_speed) {
@@ -331,7 +343,7 @@ uint16_t HOTGUN::power(void) {
 			}
 			break;
 		case POWER_PID_TUNE:
-			p = PIDTUNE::run(t);
+			p = PIDTUNE::run(t) << GUN_POWER_Q;
 			break;
 		default:
 			break;
@@ -339,6 +351,8 @@ uint16_t HOTGUN::power(void) {
 
 	// Only supply the power to the heater if the Hot Air Gun is connected
 	if (fanSpeed() < min_fan_speed || !isConnected()) p = 0;
+	fine_power	= p;
+	p = (p + (1 << (GUN_POWER_Q-1))) >> GUN_POWER_Q;		// Whole AC half-periods
 	h_power.update(p);
 	int32_t	ap	= h_power.average(p);
 	int32_t	diff 	= ap - p;
@@ -23,6 +23,8 @@
  *		Changed the internalTemp() algorithm to read the calibration data from the controller registers
  *	2025 NOV 03, v.1.12
  *		Modified the HW::init() to initialize the Hot Air Gun fan speed limits
+ *	2026 OCT 16, v.1.13
+ *		Modified the HW::init() to select the Hot Air Gun power modulator
  */
 
 #include <math.h>
@@ -72,6 +74,7 @@ CFG_STATUS HW::init(uint16_t t12_temp, uint16_t jbc_temp, uint16_t gun_temp, uin
 	hotgun.load(pp);
 	bool fast_cooling	=	cfg.isFastGunCooling();
 	hotgun.setFastGunCooling(fast_cooling);
+	hotgun.setSigmaDelta(cfg.isGunSigmaDelta());
 	uint16_t min_speed	=	cfg.minFanSpeed();
 	uint16_t max_speed	=	cfg.maxFanSpeed();
 	hotgun.setFanLimits(min_speed, max_speed);
@@ -7,6 +7,10 @@
  *  Changed PID::init() call in IRON::init(). Both irons do use the aggressive PID parameters when heat-up.
  * 2023 MAR 01, v1.01
  *  Changed IRON::lowPowerMode() switch mode to the POWER_ON in case low power mode activation
+ * 2026 OCT 16, v1.13
+ *  The PID denominator power is the IRON::pid_q template parameter, the PID output is limited by max_power
+ *  If IRON_FEED_FORWARD defined in main.h, IRON::power() learns the tip thermal model (see tmodel.h) and adds the model
+ *  feed-forward power to the PID output in POWER_ON mode
  */
 
 #include "iron.h"
@@ -28,12 +32,13 @@ void IRON::init(tDevice dev_type, uint16_t temp) {
 	h_temp.reset(temp);
 	d_power.length(ec);
 	d_temp.length(ec);
+	model.init(0, 0);										// The tip model will be loaded later, see MWORK::init()
 
 	uint32_t tim5_period = (TIM5->PSC + 1) * (TIM5->ARR + 1);
 	uint32_t cpu_speed = SystemCoreClock / 1000;			// Calculate TIM5 period in ms
 	tim5_period /= cpu_speed;
 	tim5_period <<= 1;										// Double period because the IRONS are checking consequently (see core.cpp)
-	PID::init(tim5_period, 11, true);						// Initialize PID for JBC or T12 IRON.
+	PID::init<pid_q>(tim5_period, max_power, true);			// Initialize PID for JBC or T12 IRON.
 	resetPID();
 }
 
@@ -154,8 +159,11 @@ uint16_t IRON::power(int32_t t) {
 				mode = POWER_ON;
 				PID::pidStable(stable);
 			}
-			p = PID::reqPower(temp_set, t);
+			p = PID::reqPower<pid_q>(temp_set, t);
 			p = constrain(p, 0, max_power);
+#ifdef IRON_FEED_FORWARD
+			model.learnHeating(t);
+#endif
 			break;
 		case POWER_ON:
 			if (!overheat) {
@@ -177,7 +185,12 @@ uint16_t IRON::power(int32_t t) {
 						break;
 					}
 				}
-				p = PID::reqPower(t_set, t);
+				p = PID::reqPower<pid_q>(t_set, t);
+#ifdef IRON_FEED_FORWARD
+				if (d_temp.read() < model_stable_disp && at + 10 > t_set && at < t_set + 10)
+					model.learnStable(h_power.read(), at);
+				p += model.feedForward(t_set, t);
+#endif
 				p = constrain(p, 0, max_power);
 			}
 			break;
@@ -209,6 +222,7 @@ uint16_t IRON::power(int32_t t) {
 	int32_t	ap		= h_power.average(p);
 	diff 			= ap - p;
 	d_power.update(diff*diff);
+	model.step(t, p);
 	return p;
 }
 
@@ -0,0 +1,54 @@
+/*
+ * isrprof.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  ISR execution time profiler, see isrprof.h
+ */
+
+#include "isrprof.h"
+
+void ISRSTAT::reset(void) {
+	c_min	= 0xFFFFFFFF;
+	c_max	= 0;
+	count	= 0;
+	for (uint8_t i = 0; i < PRF_BINS; ++i)
+		hist[i] = 0;
+}
+
+// Called from the IRQ handlers
+void ISRSTAT::update(uint32_t cycles) {
+	if (cycles < c_min) c_min = cycles;
+	if (cycles > c_max) c_max = cycles;
+	++count;
+	uint8_t i = 0;
+	for (uint32_t limit = PRF_BIN_BASE; i < PRF_BINS-1 && cycles >= limit; limit <<= 1)
+		++i;
+	++hist[i];
+}
+
+#ifdef ISR_PROFILE
+void ISRPROF::init(void) {
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;			// Enable the trace and debug blocks, DWT
+	DWT->CYCCNT	= 0;
+	DWT->CTRL  |= DWT_CTRL_CYCCNTENA_Msk;					// Start the cycle counter
+	reset();
+}
+
+void ISRPROF::reset(void) {
+	for (uint8_t i = 0; i < PRF_LAST; ++i)
+		stat[i].reset();
+}
+
+/*
+ * The temperature is checked at TIM5 CH4 compare event (see core.cpp), the new power value must be loaded into TIM5 before
+ * the end of TIM5 period. The TIM5 is clocked from APB1 bus, the timer clock is doubled if APB1 prescaler is not 1
+ */
+uint32_t ISRPROF::budget(void) {
+	uint32_t tim_clock = HAL_RCC_GetPCLK1Freq();
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_HCLK_DIV1)
+		tim_clock <<= 1;
+	uint32_t ticks = TIM5->ARR + 1 - TIM5->CCR4;			// TIM5 ticks from CH4 compare till the end of period
+	return ticks * (TIM5->PSC + 1) * (SystemCoreClock / tim_clock);
+}
+#endif
@@ -0,0 +1,322 @@
+/*
+ * journal.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The log-structured record journal on the W25Qxx flash, see journal.h
+ */
+
+#include <string.h>
+#include "journal.h"
+#include "W25Qxx.h"
+#include "tools.h"
+
+bool JOURNAL::init(uint16_t first_sector, uint16_t count) {
+	active			= false;
+	first			= first_sector;
+	sectors			= count;
+	cfg_loc			= 0;
+	pid_loc			= 0;
+	memset(tip_loc, 0, sizeof(tip_loc));
+	memset(clr_loc, 0, sizeof(clr_loc));
+	memset(clr_seq, 0, sizeof(clr_seq));
+	seq				= 1;
+	if (sectors < 3) return false;							// The current sector, the free sector and the sector for the garbage collector
+
+	// Find the current sector: the sector with the greatest sequence number
+	tJrnlSector	hdr;
+	bool		found	= false;
+	uint32_t	s_seq	= 0;
+	for (uint8_t i = 0; i < sectors; ++i) {
+		if (readSector(i, hdr) && (!found || hdr.seq > s_seq)) {
+			head	= i;
+			s_seq	= hdr.seq;
+			found	= true;
+		}
+	}
+	if (!found) {											// Empty journal
+		head		= sectors - 1;							// The first record opens sector 0
+		tail		= 0;
+		used		= 0;
+		head_off	= JRNL_SECTOR;
+		seq			= 1;
+		active		= true;
+		return true;
+	}
+
+	// Walk back from the current sector while the sequence number decreases
+	tail	= head;
+	used	= 1;
+	seq		= s_seq + 1;
+	while (used < sectors) {
+		uint8_t prev = (tail + sectors - 1) % sectors;
+		if (!readSector(prev, hdr) || hdr.seq >= s_seq) break;
+		s_seq	= hdr.seq;
+		tail	= prev;
+		++used;
+	}
+
+	// Scan the sectors from the oldest one, build the index
+	tJrnlBuff	rec;
+	uint8_t		s	= tail;
+	for (uint8_t n = 0; n < used; ++n) {
+		uint16_t off = sizeof(tJrnlSector);
+		while (off + sizeof(tJrnlRec) <= JRNL_SECTOR) {
+			int8_t r = readRecord(((uint32_t)(first + s) << 12) + off, rec);
+			if (r < 0) break;
+			if (r > 0) {
+				index(rec, loc(s, off));
+				if (rec.hdr.seq >= seq) seq = rec.hdr.seq + 1;
+			}
+			off += recSize(rec.hdr.size);
+		}
+		if (s == head) {
+			head_off = off;
+			if (off + sizeof(tJrnlRec) <= JRNL_SECTOR) {	// Check the rest of the sector is free
+				uint32_t addr = ((uint32_t)(first + s) << 12) + off;
+				if (W25Qxx_RET_OK != W25Qxx_Read(addr, (uint8_t *)&rec.hdr, sizeof(tJrnlRec)) || rec.hdr.type != 0xFF)
+					head_off = JRNL_SECTOR;					// The sector is damaged, use next one
+			}
+		}
+		s = (s + 1) % sectors;
+	}
+	active = true;
+	return true;
+}
+
+bool JOURNAL::format(uint16_t first_sector, uint16_t count) {
+	if (W25Qxx_RET_OK != W25Qxx_Erase(first_sector, count)) {
+		active = false;
+		return false;
+	}
+	return init(first_sector, count);
+}
+
+bool JOURNAL::load(tJrnlType type, uint8_t key, void *data, uint16_t size) {
+	if (!active) return false;
+	uint16_t l = location(type, key);
+	if (l == 0) return false;
+	tJrnlBuff rec;
+	if (readRecord(address(l), rec) <= 0 || rec.hdr.size != size)
+		return false;
+	memcpy(data, rec.data, size);
+	return true;
+}
+
+bool JOURNAL::save(tJrnlType type, uint8_t key, const void *data, uint16_t size) {
+	if (!active || type >= jr_clear || size > JRNL_MAX_DATA) return false;
+	if (type == jr_tip && key >= JRNL_TIPS) return false;
+	tJrnlBuff rec;
+	rec.hdr.type	= type;
+	rec.hdr.key		= (type == jr_tip)?key:0;
+	rec.hdr.size	= size;
+	rec.hdr.seq		= seq++;
+	memcpy(rec.data, data, size);
+	rec.hdr.crc		= crc32(rec.data, size, crc32(&rec.hdr, 8, 0));
+	return append(rec);
+}
+
+bool JOURNAL::clear(tJrnlType type) {
+	if (!active || type >= jr_clear) return false;
+	tJrnlBuff rec;
+	rec.hdr.type	= jr_clear;
+	rec.hdr.key		= type;
+	rec.hdr.size	= 0;
+	rec.hdr.seq		= seq++;
+	rec.hdr.crc		= crc32(&rec.hdr, 8, 0);
+	if (!append(rec)) return false;
+	drop(type, rec.hdr.seq);
+	clr_seq[type]	= rec.hdr.seq;
+	return true;
+}
+
+uint16_t JOURNAL::tipSlots(void) {
+	for (uint16_t i = JRNL_TIPS; i > 0; --i) {
+		if (tip_loc[i-1]) return i;
+	}
+	return 0;
+}
+
+uint16_t JOURNAL::location(tJrnlType type, uint8_t key) {
+	switch (type) {
+		case jr_config:
+			return cfg_loc;
+		case jr_pid:
+			return pid_loc;
+		case jr_tip:
+			return (key < JRNL_TIPS)?tip_loc[key]:0;
+		case jr_clear:
+			return (key < jr_clear)?clr_loc[key]:0;
+		default:
+			break;
+	}
+	return 0;
+}
+
+void JOURNAL::setLocation(tJrnlType type, uint8_t key, uint16_t l) {
+	switch (type) {
+		case jr_config:
+			cfg_loc = l;
+			break;
+		case jr_pid:
+			pid_loc = l;
+			break;
+		case jr_tip:
+			if (key < JRNL_TIPS) tip_loc[key] = l;
+			break;
+		case jr_clear:
+			if (key < jr_clear) clr_loc[key] = l;
+			break;
+		default:
+			break;
+	}
+}
+
+bool JOURNAL::readSector(uint8_t sector, tJrnlSector &hdr) {
+	if (W25Qxx_RET_OK != W25Qxx_Read((uint32_t)(first + sector) << 12, (uint8_t *)&hdr, sizeof(tJrnlSector)))
+		return false;
+	return (hdr.magic == JRNL_MAGIC && hdr.seq == ~hdr.n_seq);
+}
+
+int8_t JOURNAL::readRecord(uint32_t addr, tJrnlBuff &rec) {
+	if (W25Qxx_RET_OK != W25Qxx_Read(addr, (uint8_t *)&rec.hdr, sizeof(tJrnlRec)))
+		return -1;
+	if (rec.hdr.type == 0xFF || rec.hdr.size > JRNL_MAX_DATA)	// Free area or damaged header
+		return -1;
+	if ((addr & (JRNL_SECTOR-1)) + recSize(rec.hdr.size) > JRNL_SECTOR)
+		return -1;
+	if (rec.hdr.size > 0 && W25Qxx_RET_OK != W25Qxx_Read(addr + sizeof(tJrnlRec), rec.data, rec.hdr.size))
+		return -1;
+	if (rec.hdr.type >= jr_last || rec.hdr.crc != crc32(rec.data, rec.hdr.size, crc32(&rec.hdr, 8, 0)))
+		return 0;
+	return 1;
+}
+
+uint32_t JOURNAL::recordSeq(uint16_t l) {
+	tJrnlRec hdr;
+	if (W25Qxx_RET_OK != W25Qxx_Read(address(l), (uint8_t *)&hdr, sizeof(tJrnlRec)))
+		return 0;
+	return hdr.seq;
+}
+
+/*
+ * The records are scanned from the oldest sector, but the moved records keep their sequence numbers,
+ * so the sequence numbers are compared to find the actual record
+ */
+void JOURNAL::index(tJrnlBuff &rec, uint16_t l) {
+	tJrnlType type = (tJrnlType)rec.hdr.type;
+	if (type == jr_clear) {
+		if (rec.hdr.key >= jr_clear || rec.hdr.seq < clr_seq[rec.hdr.key]) return;
+		clr_seq[rec.hdr.key] = rec.hdr.seq;
+		clr_loc[rec.hdr.key] = l;
+		drop((tJrnlType)rec.hdr.key, rec.hdr.seq);
+		return;
+	}
+	if (rec.hdr.seq < clr_seq[type]) return;				// The record has been cleared
+	uint16_t cur = location(type, rec.hdr.key);
+	if (cur == 0 || recordSeq(cur) <= rec.hdr.seq)
+		setLocation(type, rec.hdr.key, l);
+}
+
+void JOURNAL::drop(tJrnlType type, uint32_t seq) {
+	if (type == jr_tip) {
+		for (uint16_t i = 0; i < JRNL_TIPS; ++i) {
+			if (tip_loc[i] && recordSeq(tip_loc[i]) < seq)
+				tip_loc[i] = 0;
+		}
+		return;
+	}
+	uint16_t cur = location(type, 0);
+	if (cur && recordSeq(cur) < seq)
+		setLocation(type, 0, 0);
+}
+
+bool JOURNAL::append(tJrnlBuff &rec) {
+	uint16_t size = recSize(rec.hdr.size);
+	for (uint8_t attempt = 0; attempt < 2; ++attempt) {
+		if (head_off + size > JRNL_SECTOR) {
+			for (uint8_t i = 0; i < sectors && sectors - used < 2; ++i) {	// Keep the free sector for the garbage collector
+				if (!collect()) return false;
+			}
+			if (head_off + size > JRNL_SECTOR) {			// The collector could move the records into a new sector with room enough
+				if (sectors - used < 2 || !openNext()) return false;
+			}
+		}
+		uint32_t addr	= ((uint32_t)(first + head) << 12) + head_off;
+		uint16_t l		= loc(head, head_off);
+		head_off += size;
+		memset(&rec.data[rec.hdr.size], 0xFF, size - sizeof(tJrnlRec) - rec.hdr.size);	// Keep the padding erased
+		if (W25Qxx_RET_OK == W25Qxx_Program(addr, (uint8_t *)&rec, size)) {
+			tJrnlBuff check;
+			if (readRecord(addr, check) > 0 && check.hdr.seq == rec.hdr.seq) {
+				setLocation((tJrnlType)rec.hdr.type, rec.hdr.key, l);
+				return true;
+			}
+		}
+		head_off = JRNL_SECTOR;								// The sector is damaged, try the next one
+	}
+	return false;
+}
+
+bool JOURNAL::openNext(void) {
+	if (used >= sectors) return false;
+	uint8_t next = (head + 1) % sectors;
+	if (!isErased(next) && W25Qxx_RET_OK != W25Qxx_Erase(first + next, 1))
+		return false;
+	tJrnlSector hdr;
+	hdr.magic		= JRNL_MAGIC;
+	hdr.seq			= seq++;
+	hdr.n_seq		= ~hdr.seq;
+	hdr.reserved	= 0xFFFFFFFF;
+	if (W25Qxx_RET_OK != W25Qxx_Program((uint32_t)(first + next) << 12, (uint8_t *)&hdr, sizeof(tJrnlSector)))
+		return false;
+	if (used == 0) tail = next;
+	head		= next;
+	head_off	= sizeof(tJrnlSector);
+	++used;
+	return true;
+}
+
+// Move the actual records of the oldest sector to the current one and erase the oldest sector
+bool JOURNAL::collect(void) {
+	if (used < 2) return false;								// The oldest sector is the current one
+	uint8_t		s	= tail;
+	uint16_t	off	= sizeof(tJrnlSector);
+	tJrnlBuff	rec;
+	while (off + sizeof(tJrnlRec) <= JRNL_SECTOR) {
+		int8_t r = readRecord(((uint32_t)(first + s) << 12) + off, rec);
+		if (r < 0) break;
+		uint16_t l = loc(s, off);
+		off += recSize(rec.hdr.size);
+		if (r == 0 || location((tJrnlType)rec.hdr.type, rec.hdr.key) != l)
+			continue;										// The record is not actual
+		uint16_t size = recSize(rec.hdr.size);
+		if (head_off + size > JRNL_SECTOR && !openNext())	// The free sector is used
+			return false;
+		uint32_t addr	= ((uint32_t)(first + head) << 12) + head_off;
+		uint16_t nl		= loc(head, head_off);
+		head_off += size;
+		memset(&rec.data[rec.hdr.size], 0xFF, size - sizeof(tJrnlRec) - rec.hdr.size);
+		if (W25Qxx_RET_OK != W25Qxx_Program(addr, (uint8_t *)&rec, size))
+			return false;
+		setLocation((tJrnlType)rec.hdr.type, rec.hdr.key, nl);
+	}
+	if (W25Qxx_RET_OK != W25Qxx_Erase(first + s, 1))
+		return false;
+	tail = (tail + 1) % sectors;
+	--used;
+	return true;
+}
+
+bool JOURNAL::isErased(uint8_t sector) {
+	uint32_t addr = (uint32_t)(first + sector) << 12;
+	uint32_t buff[64];										// The buffer to read data into
+	for (uint16_t i = 0; i < JRNL_SECTOR; i += sizeof(buff)) {
+		if (W25Qxx_RET_OK != W25Qxx_Read(addr + i, (uint8_t *)buff, sizeof(buff)))
+			return false;
+		for (uint8_t j = 0; j < 64; ++j) {
+			if (buff[j] != 0xFFFFFFFF) return false;
+		}
+	}
+	return true;
+}
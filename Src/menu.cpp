@@ -14,6 +14,9 @@
  *  	Added MENU_GUN::init() and MENU_GUN::loop() methods
  *  2024 NOV 05, v.1.08
  *  	Implemented 'safe_iron_mode' menu item into MSETUP:init() and MSETUP::loop()
+ *  2026 OCT 16, v.1.13
+ *  	Added 'power mode' menu item into MENU_GUN::init() and MENU_GUN::loop()
+ *  	Modified MENU_FLASH::loop() to reload the language data after the language files loaded if the font is referenced in the flash
  *
  */
 #include "menu.h"
@@ -721,6 +724,7 @@ void MENU_GUN::init(void) {
 	RENC*	pEnc	= &pCore->l_enc;
 	fast_gun_chill	= pCFG->isFastGunCooling();
 	is_fan_24v		= pCFG->isFan24v();
+	sigma_delta		= pCFG->isGunSigmaDelta();
 	stby_timeout	= pCFG->getOffTimeout(d_gun);
 	stby_temp		= pCFG->getLowTemp(d_gun);
 	set_param		= -1;
@@ -781,13 +785,17 @@ MODE* MENU_GUN::loop(void) {
 				case MG_FAN_VOLTAGE:
 					is_fan_24v	= !is_fan_24v;
 					break;
+				case MG_MODULATION:
+					sigma_delta	= !sigma_delta;
+					break;
 				case MG_SAVE:									// save
 				{
 					pD->BRGT::dim(50);							// Turn-off the brightness, processing
-					pCFG->setupGUN(fast_gun_chill, is_fan_24v, stby_timeout, stby_temp);
+					pCFG->setupGUN(fast_gun_chill, is_fan_24v, sigma_delta, stby_timeout, stby_temp);
 					pCFG->saveConfig();
 					bool fast_cooling	= pCFG->isFastGunCooling();
 					pCore->hotgun.setFastGunCooling(fast_cooling);
+					pCore->hotgun.setSigmaDelta(pCFG->isGunSigmaDelta());
 					uint16_t min_speed	= pCFG->minFanSpeed();
 					uint16_t max_speed	= pCFG->maxFanSpeed();
 					pCore->hotgun.setFanLimits(min_speed, max_speed);
@@ -862,6 +870,13 @@ MODE* MENU_GUN::loop(void) {
 				strcpy(item_value, "12v");
 			}
 			break;
+		case MG_MODULATION:
+			if (sigma_delta) {
+				strcpy(item_value, "sigma-delta");
+			} else {
+				strcpy(item_value, "pattern");
+			}
+			break;
 		default:
 			item_value[0] = '\0';
 			break;
@@ -972,6 +987,10 @@ MODE* MENU_FLASH::loop(void) {
 		switch (item) {
 			case MF_LOAD_LANG:									// Load nls language files from SD card
 				e = lang_loader.loadNLS();
+				if (pCore->nls.isFontMapped()) {				// The font file could be overwritten, reference the new one
+					pCore->nls.reloadLanguageData();
+					pCore->dspl.setLetterFont(pCore->nls.font());
+				}
 				break;
 			case MF_LOAD_CFG:									// Load main configuration files from SD card
 				e = lang_loader.loadCfg(pCore);
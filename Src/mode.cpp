@@ -52,6 +52,15 @@
  * 		Modified the MSLCT::init() to correctly check the JBC iron connectivity
  * 	2025 NOV 03, v.1.12
  * 		Updated MDEBUG::init() and MDEBUG::loop() to support Hot Air Gun fan 12v
+ * 	2026 OCT 16, v.1.13
+ * 		Modified MDEBUG::init() and MDEBUG::loop() to show the ISR profiler data instead of the title (ISR_PROFILE macro)
+ * 		Modified MDEBUG::loop() to show the AC line frequency measured by zero-cross tracker
+ * 		Modified MDEBUG::loop() to show the telemetry of the selected iron if ISR_TELEMETRY macro defined
+ * 		Modified MTPID::confirm() to commit the frame of the retained display scene
+ * 		Modified MDEBUG::loop() to show the display frames per second and the SPI bus utilization of the working mode dashboard
+ * 		Modified MDEBUG::loop() to show the worst main loop task activation delay and the glyph cache hit rate
+ * 		Modified FDEBUG::init() to export the record journal into the configuration files before the files are listed
+ * 		Modified MTACT::loop(): do not rebuild the tip table when the tip activation finished, it is updated by CFG::toggleTipActivation()
  */
 
 #include <stdio.h>
@@ -254,7 +263,6 @@ MODE* MTACT::loop(void) {
 		update_screen = 0;									// Force redraw the screen
 	} else if (button == 2) {								// Tip activation finished
 		pCFG->close();										// Finish tip list editing
-		pCFG->reloadTips();
 		// The current tip can be deactivated, so we should find the nearest tip instead
 		uint8_t curr_tip = pCFG->currentTipIndex(d_t12);
 		curr_tip = pCFG->nearActiveTip(curr_tip);
@@ -995,6 +1003,7 @@ bool MTPID::confirm(void) {
 		if (pCore->l_enc.buttonStatus() > 0)
 			return answer == 0;
 		pCore->dspl.showDialog(MSG_SAVE_Q, 150, answer == 0);
+		pCore->dspl.commit();								// The dialog has been drawn, erase the rest of the previous screen
 	}
 	return false;
 }
@@ -1373,7 +1382,11 @@ void MDEBUG::init(void) {
 	uint16_t max_fan_speed = pCore->cfg.maxFanSpeed();
 	pCore->l_enc.reset(min_fan_speed, min_fan_speed, max_fan_speed,  5, 10, false);
 	pCore->dspl.clear();
+#ifdef ISR_PROFILE
+	isrResetProfile();										// Start new ISR profiling session, see core.cpp
+#else
 	pCore->dspl.drawTitleString("Debug info");
+#endif
 	jbc_selected	= !pCore->jbc.isReedSwitch(true);		// The jbc IRON is in use, manage it, not T12
 	gun_is_on		= false;
 	fan_is_on		= false;
@@ -1478,12 +1491,24 @@ MODE* MDEBUG::loop(void) {
 	pD->debugShow(data, (!jbc_selected && old_ip > 0), (jbc_selected && old_ip > 0), pHG->isReedSwitch(true),
 			pCore->t12.isConnected(), pCore->jbc.isConnected(), pHG->isConnected(),
 			!pCore->hotgun.isReedSwitch(true), !pCore->jbc.isReedSwitch(true), pCore->jbc.isChanging(), gtim_ok);
+	pD->debugAC(acFrequency(), acJitter(), isACLocked(), schedLateness());
+#ifdef ISR_PROFILE
+	pD->debugISR(isrWorstCycles(PRF_TEMP_PATH), isrBudgetCycles());
+#endif
+#ifdef ISR_TELEMETRY
+	tTlmPhase phase = (jbc_selected)?TLM_JBC:TLM_T12;
+	pD->debugTelemetry(telemetryRate(phase), telemetryAvgPower(phase), telemetryMaxPower(phase), telemetryRipple(phase), telemetryDropped());
+#endif
+	uint32_t glyph_hits, glyph_misses;
+	u8g2_GlyphCacheStat(&glyph_hits, &glyph_misses);
+	pD->debugRefresh(pCore->refresh.fps(), pCore->refresh.busLoad(), glyph_hits, glyph_misses);
 	return this;
 }
 
 //---------------------- The Flash debug mode: display flash status & content ---
 void FDEBUG::init(void) {
 	msg = MSG_LAST;											// No error message yet
+	pCore->cfg.exportJournal();								// Show the actual configuration files
 	pCore->dspl.clear();
 	pCore->dspl.drawTitle(MSG_FLASH_DEBUG);
 	if (!pCore->cfg.W25Q::mount()) {						// The flash can be already mounted
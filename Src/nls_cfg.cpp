@@ -1,10 +1,15 @@
 /*
  * nls_cfg.cpp
  *
+ *  2026 OCT 16, v.1.13
+ *  	Modified NLS::loadFont() to reference the font in the memory mapped flash instead of loading it into the memory
+ *  	The u8g2 glyph cache is dropped when the font data is replaced or freed
  */
 
 #include <string.h>
 #include "nls_cfg.h"
+#include "W25Qxx.h"
+#include "u8g_font.h"
 
 void NLS::init(NLS_MSG *pMsg) {
 	msg_parser.setNLS_MSG(pMsg);							// Setup pointer to the NLS_MSG class instance to use NLS_MSG::set() method in the value callback procedure
@@ -17,6 +22,7 @@ void NLS::init(NLS_MSG *pMsg) {
 	lang_cfg.addEnglish();									// Add default language to the list
 	language_index	= 0;									// Current language index (English)
 	font_data		= 0;									// No font loaded
+	font_mapped		= false;
 }
 
 void NLS::loadLanguageData(uint8_t index) {
@@ -40,10 +46,20 @@ void NLS::loadLanguageData(const char *language) {
 	loadLanguageData(indx);
 }
 
+void NLS::reloadLanguageData(void) {
+	uint8_t index = language_index;
+	defaultNLS();
+	language_index = 0;
+	loadLanguageData(index);
+}
+
 void NLS::defaultNLS() {
+	u8g2_GlyphCacheReset();									// The new font can be loaded at the same address
 	if (font_data) {
-		free(font_data);
+		if (!font_mapped)
+			free(font_data);
 		font_data			= 0;
+		font_mapped			= false;
 		language_index		= 0;
 	}
 }
@@ -100,6 +116,14 @@ bool NLS::loadFont(uint8_t indx) {
 		return false;
 	if (FR_OK != f_open(&cfg_f, cfg_path.c_str(), FA_READ))
 		return false;
+	font_data = mappedFont(fno.fsize);
+	if (font_data) {										// The font can be used in place
+		f_close(&cfg_f);
+		font_mapped = true;
+		u8g2_GlyphCacheReset();
+		return true;
+	}
+	f_lseek(&cfg_f, 0);
 	font_data = (uint8_t *)malloc(fno.fsize);				// Try to allocate memory for the font
 	if (!font_data) {
 		f_close(&cfg_f);
@@ -113,9 +137,32 @@ bool NLS::loadFont(uint8_t indx) {
 		font_data = 0;
 		return false;
 	}
+	u8g2_GlyphCacheReset();
 	return true;
 }
 
+/*
+ * If the flash is memory mapped, the font data can be read directly from the flash when the font file occupies
+ * the contiguous clusters. The language files are written once, so usually they are not fragmented
+ */
+uint8_t* NLS::mappedFont(uint32_t size) {
+	FATFS	*fs		= cfg_f.obj.fs;
+	DWORD	first	= cfg_f.obj.sclust;
+	if (first < 2 || !W25Qxx_MapAddress(0))					// Empty file or the flash is not mapped
+		return 0;
+	uint32_t ssize = 4096;									// W25Qxx sector size
+#if FF_MAX_SS != FF_MIN_SS
+	ssize = fs->ssize;
+#endif
+	uint32_t c_size = fs->csize * ssize;					// The cluster size in bytes
+	for (DWORD c = 1; c * c_size < size; ++c) {				// Check every next cluster of the file follows the previous one
+		if (FR_OK != f_lseek(&cfg_f, c * c_size + 1) || cfg_f.clust != first + c)
+			return 0;
+	}
+	LBA_t sector = fs->database + (LBA_t)(first - 2) * fs->csize;
+	return (uint8_t *)W25Qxx_MapAddress(sector * ssize);
+}
+
 bool NLS::loadMessages(uint8_t indx) {
 	if (FR_OK != f_mount(&flashfs, "0:/", 1))				// Try to mount SPI flash
 		return false;
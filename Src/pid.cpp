@@ -7,11 +7,13 @@
  *  	When the temperature is far lower than the preset one, the aggressive PID parameters are used
  * 2025 MAY 21, v.1.10
  * 		Deleted twice initializing of power variable in PID::reqPower()
+ * 2026 OCT 16, v.1.13
+ * 		PID::init() and PID::reqPower() moved to pid.h as templates with the denominator power as parameter
+ * 		PID::newPIDparams() uses integer arithmetic only
  */
 
 #include "pid.h"
 #include "tools.h"
-#include <math.h>
 
 PIDparam::PIDparam(int32_t Kp, int32_t Ki, int32_t Kd) {
 	this->Kp	= Kp;
@@ -29,36 +31,26 @@ PIDparam::PIDparam(const PIDparam &p) {
 // Increase the Kp in the aggressive mode in several times,
 // Decrease the Ki in the aggressive mode. The Kd is not used in the aggressive mode
 void PID::load(const PIDparam &p) {
-	Kp	= p.Kp;
-	Ki	= p.Ki;
-	Kd	= p.Kd;
-	Kp_force = Kp * 5;
-	Ki_force = Ki / 10;
-	if (Ki_force < 5) Ki_force = 5;
-}
-
-void PID::init(uint16_t ms, uint8_t denominator_p, bool heat_force) { // PID parameters are initialized from EEPROM by  call
-	Kp	= 10;
-	Ki	= 10;
-	Kd  = 0;
-	T	= ms;
-	Kp_force	= 10;
-	Ki_force	= 5;
-	this->denominator_p = denominator_p;
-	use_force	= heat_force;
+	k[0].Kp	= p.Kp;
+	k[0].Ki	= p.Ki;
+	k[0].Kd	= p.Kd;
+	k[1].Kp	= p.Kp * 5;
+	k[1].Ki	= p.Ki / 10;
+	if (k[1].Ki < 5) k[1].Ki = 5;
+	k[1].Kd	= 0;
 }
 
 int32_t PID::changePID(uint8_t p, int32_t k) {
 	switch(p) {
     	case 1:
-    		if (k >= 0) Kp = k;
-    		return Kp;
+    		if (k >= 0) this->k[0].Kp = k;
+    		return this->k[0].Kp;
     	case 2:
-    		if (k >= 0) Ki = k;
-    		return Ki;
+    		if (k >= 0) this->k[0].Ki = k;
+    		return this->k[0].Ki;
     	case 3:
-    		if (k >= 0) Kd = k;
-    		return Kd;
+    		if (k >= 0) this->k[0].Kd = k;
+    		return this->k[0].Kd;
     	default:
     		break;
 	}
@@ -74,14 +66,19 @@ int32_t PID::changePID(uint8_t p, int32_t k) {
  * Kp = 0.6*Ku; Ti = 0.5*Pu; Td = 0.125*Pu;
  * Ki = Kp*T/Ti;
  * Kd = Kp*Td/T;
+ *
+ * Kp = 0.6 * 4 / PI * delta_power / SQRT(diff). The 2.4/PI constant is 50066/65536,
+ * SQRT(diff) is calculated as isqrt(diff * 65536) / 256 to keep the precision of small oscillation amplitudes
  */
 void PID::newPIDparams(uint16_t delta_power, uint32_t diff, uint32_t period) {
-	double Ku  = 4 * delta_power;
-	Ku /= M_PI * sqrt(diff);
-	uint32_t denominator = 1 << denominator_p;
-	Kp = round(Ku * 0.6 * denominator);						// Translate Kp to the numerator of implemented PID
-	Ki = (Kp * T * 2 + period/2) / period;
-	Kd = (Kp * period) >> 3;								// 1/8 = 0.125
+	const uint64_t ku_const	= 50066;						// 2.4 / PI * 65536
+	uint64_t sqrt_diff	= isqrt((uint64_t)diff << 16);		// SQRT(diff) * 256
+	if (sqrt_diff == 0) return;
+	uint64_t num = ((uint64_t)delta_power * ku_const) << denominator_p;
+	uint64_t den = sqrt_diff << 8;
+	int32_t Kp = (num + (den >> 1)) / den;					// Translate Kp to the numerator of implemented PID
+	int32_t Ki = (Kp * T * 2 + period/2) / period;
+	int32_t Kd = (Kp * period) >> 3;						// 1/8 = 0.125
 	Kd += T/2;
 	Kd /= T;
 	/*
@@ -90,6 +87,9 @@ void PID::newPIDparams(uint16_t delta_power, uint32_t diff, uint32_t period) {
 	 *  That is why it is better to limit the Kd value.
 	 */
 	if (Kd > 10000) Kd = Kp/2;
+	k[0].Kp	= Kp;
+	k[0].Ki	= Ki;
+	k[0].Kd	= Kd;
 }
 
 void PID::resetPID(uint16_t t) {
@@ -98,36 +98,6 @@ void PID::resetPID(uint16_t t) {
 	power 	= 0;
 }
 
-int32_t PID::reqPower(int16_t temp_set, int16_t temp_curr) {
-	if (use_force && temp_curr + 100 < temp_set) {			// Aggressive heat-up mode, use Kp_force and Ki_forse only
-		if (temp_h0 == 0) {									// Use direct formulae because do not know previous temperature
-			int32_t	i_summ 	= temp_set - temp_curr;
-			power = Kp_force*(temp_set - temp_curr) + Ki_force * i_summ;
-		} else {
-			int32_t kp = Kp_force * (temp_h1 	- temp_curr);
-			int32_t ki = Ki_force * (temp_set	- temp_curr);
-			int32_t delta_p = kp + ki;
-			power += delta_p;								// Power is stored multiplied by denominator!
-		}
-	} else {												// Use regular PID parameters near preset temperature
-		if (temp_h0 == 0) {									// Use direct formulae because do not know previous temperature
-			int32_t	i_summ 	= temp_set - temp_curr;
-			power = Kp*(temp_set - temp_curr) + Ki * i_summ;
-		} else {
-			int32_t kp = Kp * (temp_h1 	- temp_curr);
-			int32_t ki = Ki * (temp_set	- temp_curr);
-			int32_t kd = Kd * (temp_h0 	+ temp_curr - 2 * temp_h1);
-			int32_t delta_p = kp + ki + kd;
-			power += delta_p;								// Power is stored multiplied by denominator!
-		}
-	}
-	temp_h0 = temp_h1;
-	temp_h1 = temp_curr;
-	int32_t pwr = power + (1 << (denominator_p-1));			// prepare the power to divide by denominator, round the result
-	pwr >>= denominator_p;									// divide by the denominator
-	return pwr;
-}
-
 void PIDTUNE::start(uint16_t base_pwr, uint16_t delta_power, uint16_t base_temp, uint16_t delta_temp) {
 	if (base_pwr && delta_power) {
 		this->base_power	= base_pwr;						// The power required to keep the preset temperature
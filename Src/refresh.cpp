@@ -0,0 +1,79 @@
+/*
+ * refresh.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The refresh governor of the main working mode dashboard, see refresh.h
+ */
+
+#include "refresh.h"
+#include "ll_spi.h"
+
+// The display bus statistics are provided by the SPI interface only. The zero bit rate means no bus data, so the bus load is zero
+#ifdef TFT_SPI_PORT
+static uint32_t busBytes(void)		{ return TFT_SPI_BusBytes();	}
+static uint32_t busBitRate(void)	{ return TFT_SPI_BitRate();		}
+#else
+static uint32_t busBytes(void)		{ return 0;						}
+static uint32_t busBitRate(void)	{ return 0;						}
+#endif
+
+void REFRESH::start(void) {
+	frames		= 0;
+	win_start	= HAL_GetTick();
+	win_bytes	= busBytes();
+	force		= true;
+}
+
+void REFRESH::activity(void) {
+	fast_until	= HAL_GetTick() + hold_time;
+	force		= true;
+}
+
+void REFRESH::watch(uint8_t unit, uint16_t temp, uint16_t disp) {
+	if (unit >= RFR_UNITS) return;
+	uint16_t delta		= (temp > last_temp[unit])?temp - last_temp[unit]:last_temp[unit] - temp;
+	last_temp[unit]		= temp;
+	if (delta >= fast_delta) {
+		rate[unit]		= RFR_FAST;
+	} else if (delta > stable_delta || disp > stable_disp) {
+		rate[unit]		= RFR_NORMAL;
+	} else {
+		rate[unit]		= RFR_STABLE;
+	}
+}
+
+uint16_t REFRESH::period(void) {
+	if (HAL_GetTick() < fast_until) return fast_period;
+	tRfrRate r = RFR_STABLE;
+	for (uint8_t i = 0; i < RFR_UNITS; ++i) {
+		if (rate[i] > r) r = rate[i];
+	}
+	if (r == RFR_FAST)		return fast_period;
+	if (r == RFR_NORMAL)	return normal_period;
+	return slow_period;
+}
+
+bool REFRESH::frame(void) {
+	if (!force && HAL_GetTick() - last_frame < period()) return false;
+	force = false;
+	count();
+	return true;
+}
+
+void REFRESH::count(void) {
+	uint32_t now = HAL_GetTick();
+	last_frame = now;
+	++frames;
+	uint32_t elapsed = now - win_start;
+	if (elapsed < 1000) return;
+	uint32_t bytes	= busBytes();
+	uint32_t bits	= (bytes - win_bytes) << 3;
+	uint32_t bus_cap = busBitRate() / 100000 * elapsed;	// The number of bits the bus can send during the window divided by 100
+	s_fps		= frames * 10000 / elapsed;
+	s_bus		= (bus_cap > 0)?bits / bus_cap:0;
+	if (s_bus > 100) s_bus = 100;
+	frames		= 0;
+	win_start	= now;
+	win_bytes	= bytes;
+}
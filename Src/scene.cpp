@@ -0,0 +1,221 @@
+/*
+ * scene.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The retained scene of the display, see scene.h
+ */
+
+#include "scene.h"
+
+uint32_t SCENE::hash(const void *data, uint32_t size, uint32_t h) {
+	const uint8_t *p = (const uint8_t *)data;
+	while (size--) {
+		h ^= *p++;
+		h *= 16777619U;
+	}
+	return h;
+}
+
+#ifdef UI_RETAINED
+bool SCENE::begin(void) {
+	if (!valid) {											// Nothing is known about the screen content
+		reset();
+		return false;
+	}
+	for (uint8_t i = 0; i < nodes; ++i)
+		node[i].stale = true;
+	if (residue.x0 < residue.x1) {
+		merge(res_stale, residue.x0, residue.y0, residue.x1 - residue.x0, residue.y1 - residue.y0);
+		residue = {0, 0, 0, 0};
+	}
+	frame = true;
+	return true;
+}
+
+void SCENE::reset(void) {
+	nodes		= 0;
+	residue		= {0, 0, 0, 0};
+	res_stale	= {0, 0, 0, 0};
+	frame		= false;
+	valid		= true;
+}
+
+bool SCENE::paint(tSceneKind kind, int16_t x, int16_t y, uint16_t width, uint16_t height, uint32_t sig, bool opaque) {
+	if (!valid || width == 0 || height == 0) return true;
+	uint8_t k	= kind;
+	sig			= hash(&k, 1, sig);
+	int16_t found = -1;
+	for (uint8_t i = 0; i < nodes; ++i) {
+		tNode &n = node[i];
+		if (n.x == x && n.y == y && n.w == width && n.h == height) {
+			found = i;
+			break;
+		}
+	}
+	uint32_t area = (uint32_t)width * height;
+	if (opaque && found >= 0 && node[found].clean && node[found].sig == sig) {
+		node[found].stale	= false;						// The node is already on the screen
+		node[found].used	= ++use_cnt;
+		kept += area;
+		return false;
+	}
+
+	if (frame && !opaque)									// Erase the stale content under the transparent node
+		eraseStale(x, y, width, height);
+	for (uint8_t i = 0; i < nodes; ) {
+		tNode &n = node[i];
+		if (i != found && overlap(n, x, y, width, height)) {
+			if (opaque && n.x >= x && n.y >= y && n.x + n.w <= x + width && n.y + n.h <= y + height) {
+				removeNode(i);								// The node is completely covered by the new one
+				if (found == nodes) found = i;				// The last node has been moved to the released place
+				continue;
+			}
+			n.clean = false;
+		}
+		++i;
+	}
+	if (found < 0) found = newNode();
+	tNode &n = node[found];
+	n.x		= x;
+	n.y		= y;
+	n.w		= width;
+	n.h		= height;
+	n.sig	= sig;
+	n.used	= ++use_cnt;
+	n.clean	= opaque;										// The transparent node depends on the content under it
+	n.stale	= false;
+	painted += area;
+	return true;
+}
+
+void SCENE::commit(void) {
+	if (!frame) return;
+	frame = false;
+	for (uint8_t i = 0; i < nodes; ) {
+		if (node[i].stale) {
+			tNode n = node[i];
+			removeNode(i);
+			erase(n.x, n.y, n.w, n.h);
+			continue;
+		}
+		++i;
+	}
+	if (res_stale.x0 < res_stale.x1) {
+		tArea a		= res_stale;
+		res_stale	= {0, 0, 0, 0};
+		erase(a.x0, a.y0, a.x1 - a.x0, a.y1 - a.y0);
+	}
+}
+
+/*
+ * Erase the area except the areas of the nodes drawn in the current frame. The area outside of the node is split into
+ * up to four bands (above, below, left and right of the node) and every band is checked against the rest of the nodes.
+ */
+void SCENE::erase(int32_t x, int32_t y, int32_t w, int32_t h, uint8_t first) {
+	if (w <= 0 || h <= 0) return;
+	for (uint8_t i = first; i < nodes; ++i) {
+		const tNode &f = node[i];
+		if (f.stale || !overlap(f, x, y, w, h)) continue;
+		int32_t fx1 = f.x + f.w;
+		int32_t fy1 = f.y + f.h;
+		if (y < f.y) {										// The band above the node
+			erase(x, y, w, f.y - y, i+1);
+			h -= f.y - y;
+			y  = f.y;
+		}
+		if (y + h > fy1) {									// The band below the node
+			erase(x, fy1, w, y + h - fy1, i+1);
+			h = fy1 - y;
+		}
+		if (x < f.x)										// The band left of the node
+			erase(x, y, f.x - x, h, i+1);
+		if (x + w > fx1)									// The band right of the node
+			erase(fx1, y, x + w - fx1, h, i+1);
+		return;												// The rest of the area is covered by the node
+	}
+	if (x < 0) {
+		w += x;
+		x  = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y  = 0;
+	}
+	if (w <= 0 || h <= 0) return;
+	for (uint8_t i = 0; i < nodes; ++i) {					// The stale nodes are changed
+		if (node[i].stale && overlap(node[i], x, y, w, h))
+			node[i].clean = false;
+	}
+	eraseArea(x, y, w, h);
+	erased += w * h;
+}
+
+// Erase the stale nodes inside the area
+void SCENE::eraseStale(int16_t x, int16_t y, uint16_t w, uint16_t h) {
+	int32_t x1 = x + w;
+	int32_t y1 = y + h;
+	for (uint8_t i = 0; i < nodes; ++i) {
+		const tNode &n = node[i];
+		if (!n.stale || !overlap(n, x, y, w, h)) continue;
+		int32_t ix0 = (n.x > x)?n.x:x;
+		int32_t iy0 = (n.y > y)?n.y:y;
+		int32_t ix1 = (n.x + n.w < x1)?n.x + n.w:x1;
+		int32_t iy1 = (n.y + n.h < y1)?n.y + n.h:y1;
+		erase(ix0, iy0, ix1 - ix0, iy1 - iy0);
+	}
+	const tArea &r = res_stale;
+	if (r.x0 < x1 && x < r.x1 && r.y0 < y1 && y < r.y1) {
+		int32_t ix0 = (r.x0 > x)?r.x0:x;
+		int32_t iy0 = (r.y0 > y)?r.y0:y;
+		int32_t ix1 = (r.x1 < x1)?r.x1:x1;
+		int32_t iy1 = (r.y1 < y1)?r.y1:y1;
+		erase(ix0, iy0, ix1 - ix0, iy1 - iy0);
+	}
+}
+
+/*
+ * Use free node or drop the least recently used one. The stale node is dropped first, its area is erased now.
+ * The current node can be dropped when the frame is closed only, otherwise its area could be erased by commit()
+ */
+uint8_t SCENE::newNode(void) {
+	if (nodes < UI_RETAINED)
+		return nodes++;
+	uint8_t lru = nodes;
+	for (uint8_t i = 0; i < nodes; ++i) {
+		if (node[i].stale && (lru >= nodes || node[i].used < node[lru].used))
+			lru = i;
+	}
+	if (lru < nodes) {
+		tNode n = node[lru];
+		node[lru].stale = false;
+		node[lru].w		= 0;								// Do not keep the area of the node while erasing
+		erase(n.x, n.y, n.w, n.h);
+		return lru;
+	}
+	commit();												// There is no stale node, close the frame
+	lru = 0;
+	for (uint8_t i = 1; i < nodes; ++i) {
+		if (node[i].used < node[lru].used)
+			lru = i;
+	}
+	merge(residue, node[lru].x, node[lru].y, node[lru].w, node[lru].h);	// The area should be erased by the next frame
+	return lru;
+}
+
+void SCENE::removeNode(uint8_t i) {
+	if (i >= nodes) return;
+	node[i] = node[--nodes];
+}
+
+void SCENE::merge(tArea &a, int16_t x, int16_t y, uint16_t w, uint16_t h) {
+	if (a.x0 >= a.x1) {										// Empty area
+		a = {x, y, (int16_t)(x + w), (int16_t)(y + h)};
+		return;
+	}
+	if (x < a.x0)		a.x0 = x;
+	if (y < a.y0)		a.y0 = y;
+	if (x + w > a.x1)	a.x1 = x + w;
+	if (y + h > a.y1)	a.y1 = y + h;
+}
+#endif
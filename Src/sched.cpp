@@ -0,0 +1,52 @@
+/*
+ * sched.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  Cooperative scheduler of the main loop periodic tasks, see sched.h
+ */
+
+#include "sched.h"
+
+int8_t SCHED::add(tTaskFunc func, uint32_t period, uint32_t delay) {
+	if (len >= SCHED_MAX_TASKS || func == 0) return -1;
+	if (period == 0) period = 1;							// Prevent endless loop in run()
+	task[len].func		= func;
+	task[len].period	= period;
+	task[len].deadline	= HAL_GetTick() + delay;
+	order[len]			= len;
+	reorder(len);
+	return len++;
+}
+
+// The tick counter can overflow, so compare the deadlines by the signed difference
+void SCHED::reorder(uint8_t pos) {
+	uint8_t id = order[pos];
+	uint32_t dl = task[id].deadline;
+	while (pos > 0 && (int32_t)(dl - task[order[pos-1]].deadline) < 0) {
+		order[pos] = order[pos-1];
+		--pos;
+	}
+	while (pos+1 < len && (int32_t)(task[order[pos+1]].deadline - dl) <= 0) {
+		order[pos] = order[pos+1];
+		++pos;
+	}
+	order[pos] = id;
+}
+
+void SCHED::run(void) {
+	uint32_t now = HAL_GetTick();
+	while (len > 0) {
+		tTask *t = &task[order[0]];
+		int32_t late = now - t->deadline;
+		if (late < 0) break;								// The first task in the list is not ready, so no task is ready
+		if ((uint32_t)late > max_late) max_late = late;
+		t->deadline += t->period;
+		if ((int32_t)(now - t->deadline) >= 0)				// The task is late more than its period, skip missed activations
+			t->deadline = now + t->period;
+		reorder(0);
+		t->func();
+		now = HAL_GetTick();
+	}
+	__WFI();												// Sleep till the next interrupt
+}
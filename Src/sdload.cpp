@@ -7,11 +7,17 @@
  * Sep 05 2023
  *    Changed the file name type from std::string to const char *
  *    Modified the SDLOAD::haveToUpdate() and SDLOAD::copyFile()
+ * Oct 16 2026
+ *    SDLOAD::loadCfg() and SDLOAD::saveCfg() export the record journal into the configuration files first (see journal.h).
+ *    SDLOAD::loadCfg() drops the journal when the files have been loaded and converts the tip calibration file of old format
+ *    SDLOAD::allocateCopyBuffer() tries the bigger buffer first: FatFS reads the SD-CARD by multiple blocks (CMD18) directly into the buffer
+ *    SDLOAD::copyLanguageData() copies the changed language files only, see SDLOAD::syncFile()
  *
  */
 
 #include "sdload.h"
 #include "jsoncfg.h"
+#include "tools.h"
 
 t_msg_id SDLOAD::loadNLS(void) {
 	t_msg_id e = startNLS();
@@ -29,6 +35,7 @@ t_msg_id SDLOAD::loadNLS(void) {
 }
 
 t_msg_id SDLOAD::loadCfg(HW* core) {
+	core->cfg.exportJournal();								// Keep the actual records of the files missing on the SD-CARD
 	if (FR_OK != f_mount(&flashfs, "0:/", 1)) {
 		return MSG_EEPROM_WRITE;
 	}
@@ -44,6 +51,9 @@ t_msg_id SDLOAD::loadCfg(HW* core) {
 		copyFile(fn, true);									// Copy file from SD-CARD to the FLASH
 	}
 	umountAll();
+	core->cfg.dropJournal();								// The loaded files are actual now
+	core->cfg.checkTipFile();								// The loaded tip calibration file can have old format
+	core->cfg.umount();
 	if (buffer) {											// Deallocate copy buffer memory
 		free(buffer);
 		buffer_size = 0;
@@ -52,6 +62,7 @@ t_msg_id SDLOAD::loadCfg(HW* core) {
 }
 
 t_msg_id SDLOAD::saveCfg(HW *core) {
+	core->cfg.exportJournal();
 	if (FR_OK != f_mount(&flashfs, "0:/", 1)) {
 		return MSG_EEPROM_WRITE;
 	}
@@ -102,7 +113,7 @@ void SDLOAD::umountAll(void) {
 }
 
 bool SDLOAD::allocateCopyBuffer(void) {
-	for (uint8_t i = 0; i < 3; ++i) {
+	for (uint8_t i = 0; i < sizeof(b_sizes) / sizeof(b_sizes[0]); ++i) {
 		buffer = (uint8_t *)malloc(b_sizes[i]);
 		if (buffer) {										// Successfully allocated
 			buffer_size = b_sizes[i];
@@ -119,15 +130,15 @@ uint8_t SDLOAD::copyLanguageData(void) {
 		lang_list->pop_back();
 		bool lang_ok = isLanguageDataConsistent(lang);		// Check the language files exist
 		if (lang_ok)
-			lang_ok = copyFile(lang.messages_file.c_str(), true);
+			lang_ok = syncFile(lang.messages_file.c_str());
 		if (lang_ok)
-			lang_ok = copyFile(lang.font_file.c_str(), true);
+			lang_ok = syncFile(lang.font_file.c_str());
 		if (lang_ok)
 			++l_copied;
 	}
 	if (l_copied > 0) {
 		std::string cfg_name = fn_cfg;
-		if (copyFile(cfg_name.c_str(), true))
+		if (syncFile(cfg_name.c_str()))
 			return l_copied;
 	}
 	return 0;
@@ -212,3 +223,136 @@ bool SDLOAD::copyFile(const char *name, bool load) {
 	}
 	return copied;
 }
+
+/*
+ * Copy the language file from the SD-CARD to the SPI FLASH if the file has been changed.
+ * The manifest keeps the size, the timestamp and CRC-32 of the source file copied. If the source file size and timestamp are the same
+ * as in the manifest, the source file is not read at all. Otherwise the CRC-32 of the source file is checked, so the file
+ * with changed timestamp only is not copied again.
+ * The file is copied into the temporary file (name.tmp) that is synchronized after every buffer written. If the power was lost,
+ * the copy is resumed from the end of the temporary file next time. The temporary file is checked by CRC-32 and renamed at the end.
+ */
+bool SDLOAD::syncFile(const char *name) {
+	if (strlen(name) >= sizeof(t_sync_entry::name) || !buffer || buffer_size == 0)
+		return copyFile(name, true);						// The name is too long for the manifest
+	std::string src = "1:" + std::string(name);
+	std::string dst = "0:" + std::string(name);
+	std::string tmp = dst + ".tmp";
+	FILINFO sno, fno;
+	if (FR_OK != f_stat(src.c_str(), &sno))
+		return false;
+	uint32_t src_time	= sno.fdate << 16 | sno.ftime;
+	bool dst_ok			= (FR_OK == f_stat(dst.c_str(), &fno) && fno.fsize == sno.fsize);
+
+	t_sync_entry e;
+	int16_t index = findEntry(name, e);
+	bool synced = (index >= 0 && e.state == SYNC_DONE && dst_ok && e.size == sno.fsize);
+	if (synced && e.time == src_time)						// The source file has not been changed
+		return true;
+	uint32_t crc = 0;
+	if (!fileCRC(src.c_str(), crc))
+		return false;
+	if (synced && e.crc == crc) {							// Only the timestamp has been changed
+		e.time = src_time;
+		return saveEntry(e, index) >= 0;
+	}
+
+	uint32_t done = 0;										// The data size already copied into the temporary file
+	if (index >= 0 && e.state == SYNC_COPY && e.size == sno.fsize && e.crc == crc) {
+		if (FR_OK == f_stat(tmp.c_str(), &fno) && fno.fsize <= sno.fsize)
+			done = fno.fsize;
+	}
+	if (done == 0) {										// Start new copy
+		memset((void *)&e, 0, sizeof(t_sync_entry));
+		strncpy(e.name, name, sizeof(e.name));
+		e.size	= sno.fsize;
+		e.time	= src_time;
+		e.crc	= crc;
+		e.state	= SYNC_COPY;
+		index	= saveEntry(e, index);
+		if (index < 0)
+			return false;
+	}
+
+	FIL	sf, df;												// Source and destination file descriptors
+	if (FR_OK != f_open(&sf, src.c_str(), FA_READ))
+		return false;
+	if (FR_OK != f_open(&df, tmp.c_str(), (done > 0)?(FA_OPEN_EXISTING | FA_WRITE):(FA_CREATE_ALWAYS | FA_WRITE))) {
+		f_close(&sf);
+		return false;
+	}
+	bool copied = (FR_OK == f_lseek(&sf, done) && FR_OK == f_lseek(&df, done));
+	while (copied) {										// The file copy loop
+		UINT br = 0;
+		f_read(&sf, (void *)buffer, (UINT)buffer_size, &br);
+		if (br == 0)										// End of source file
+			break;
+		UINT written = 0;
+		f_write(&df, (void *)buffer, br, &written);
+		copied = (written == br && FR_OK == f_sync(&df));	// Keep the temporary file size actual to resume the copy
+	}
+	f_close(&df);
+	f_close(&sf);
+	uint32_t tmp_crc = 0;
+	if (copied)
+		copied = fileCRC(tmp.c_str(), tmp_crc) && tmp_crc == crc;
+	if (!copied) {
+		f_unlink(tmp.c_str());								// Start from the beginning next time
+		return false;
+	}
+	f_unlink(dst.c_str());
+	if (FR_OK != f_rename(tmp.c_str(), dst.c_str()))
+		return false;
+	f_utime(dst.c_str(), &sno);
+	e.state = SYNC_DONE;
+	return saveEntry(e, index) >= 0;
+}
+
+bool SDLOAD::fileCRC(const char *path, uint32_t &crc) {
+	if (FR_OK != f_open(&cfg_f, path, FA_READ))
+		return false;
+	crc = 0;
+	bool ret = true;
+	while (true) {
+		UINT br = 0;
+		if (FR_OK != f_read(&cfg_f, (void *)buffer, (UINT)buffer_size, &br)) {
+			ret = false;
+			break;
+		}
+		if (br == 0)
+			break;
+		crc = crc32(buffer, br, crc);
+	}
+	f_close(&cfg_f);
+	return ret;
+}
+
+// The entry with wrong CRC (the power was lost while the entry being written) is ignored
+int16_t SDLOAD::findEntry(const char *name, t_sync_entry &e) {
+	if (FR_OK != f_open(&cfg_f, fn_manifest, FA_READ))
+		return -1;
+	int16_t index = -1;
+	for (int16_t i = 0; index < 0; ++i) {
+		UINT br = 0;
+		if (FR_OK != f_read(&cfg_f, (void *)&e, sizeof(t_sync_entry), &br) || br != sizeof(t_sync_entry))
+			break;
+		if (e.rec_crc == crc32(&e, sizeof(t_sync_entry) - sizeof(uint32_t), 0) && strncmp(e.name, name, sizeof(e.name)) == 0)
+			index = i;
+	}
+	f_close(&cfg_f);
+	return index;
+}
+
+int16_t SDLOAD::saveEntry(t_sync_entry &e, int16_t index) {
+	if (FR_OK != f_open(&cfg_f, fn_manifest, FA_OPEN_ALWAYS | FA_WRITE))
+		return -1;
+	if (index < 0)											// Append new entry, overwrite the incomplete entry at the end of the file
+		index = f_size(&cfg_f) / sizeof(t_sync_entry);
+	e.rec_crc = crc32(&e, sizeof(t_sync_entry) - sizeof(uint32_t), 0);
+	UINT written = 0;
+	if (FR_OK != f_lseek(&cfg_f, index * sizeof(t_sync_entry)) || FR_OK != f_write(&cfg_f, (void *)&e, sizeof(t_sync_entry), &written)
+			|| written != sizeof(t_sync_entry))
+		index = -1;
+	f_close(&cfg_f);
+	return index;
+}
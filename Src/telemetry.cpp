@@ -0,0 +1,53 @@
+/*
+ * telemetry.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The control path telemetry, see telemetry.h
+ */
+
+#include "telemetry.h"
+
+#ifdef ISR_TELEMETRY
+void TELEMETRY::put(tTlmPhase phase, uint16_t raw, uint16_t power) {
+	tTlmSample s;
+	s.raw	= raw;
+	s.power	= power;
+	s.phase	= phase;
+	s.seq	= seq++;
+	ring.push(s);
+}
+
+void TELEMETRY::drain(void) {
+	tTlmSample s;
+	while (ring.pop(s)) {
+		lost	+= (uint16_t)(s.seq - next_seq);			// The samples dropped by the producer while the ring was full
+		next_seq = s.seq + 1;
+		if (s.phase >= TLM_LAST) continue;
+		uint8_t i = s.phase;
+		if (cnt[i] == 0) {
+			r_min[i] = r_max[i] = s.raw;
+		} else if (s.raw < r_min[i]) {
+			r_min[i] = s.raw;
+		} else if (s.raw > r_max[i]) {
+			r_max[i] = s.raw;
+		}
+		++cnt[i];
+		p_sum[i] += s.power;
+		if (s.power > p_max[i]) p_max[i] = s.power;
+	}
+	uint32_t now = HAL_GetTick();
+	if (now < period_end) return;
+	period_end = now + 1000;
+	for (uint8_t i = 0; i < TLM_LAST; ++i) {
+		s_rate[i]	= cnt[i];
+		s_avg[i]	= (cnt[i] > 0)?p_sum[i] / cnt[i]:0;
+		s_max[i]	= p_max[i];
+		s_ripple[i]	= r_max[i] - r_min[i];
+		cnt[i]		= 0;
+		p_sum[i]	= 0;
+		p_max[i]	= 0;
+		r_min[i]	= r_max[i] = 0;
+	}
+}
+#endif
@@ -0,0 +1,58 @@
+/*
+ * tmodel.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The learned thermal model of the IRON tip, see tmodel.h
+ */
+
+#include "tmodel.h"
+
+void TMODEL::init(uint16_t capacity, uint16_t loss) {
+	h_cap.length(cap_len);
+	h_loss.length(loss_len);
+	h_cap.reset(capacity);
+	h_loss.reset(loss);
+	cap_ready	= (capacity > 0);
+	loss_ready	= (loss > 0);
+	t_prev		= 0;
+	p_prev		= 0;
+}
+
+// Called when the IRON keeps the preset temperature. The average power compensates the heat loss completely
+void TMODEL::learnStable(int32_t avg_power, int32_t avg_temp) {
+	if (avg_temp < min_temp || avg_power <= 0) return;
+	int32_t l = (avg_power << 8) / avg_temp;				// Q8
+	if (l > 0xFFFF) l = 0xFFFF;
+	if (loss_ready) {
+		h_loss.update(l);
+	} else {
+		h_loss.reset(l);
+		loss_ready = true;
+	}
+}
+
+// Called when the IRON is heating up. The previous step power minus the heat loss raises the tip temperature
+void TMODEL::learnHeating(int32_t t) {
+	int32_t dt = t - t_prev;
+	if (t_prev == 0 || dt < min_rise || p_prev <= 0) return;
+	int32_t p = p_prev - ((int32_t)loss() * t_prev >> 8);	// The power spent to heat up the tip
+	if (p <= 0) return;
+	int32_t c = (p << 4) / dt;								// Q4
+	if (c > 0xFFFF) c = 0xFFFF;
+	if (cap_ready) {
+		h_cap.update(c);
+	} else {
+		h_cap.reset(c);
+		cap_ready = true;
+	}
+}
+
+int32_t TMODEL::feedForward(int32_t t_set, int32_t t) {
+	if (!isReady()) return 0;
+	int32_t ff = ((int32_t)loss() * t_set * ss_share) >> 10;	// The share of the steady-state power, (n/4) * L * T
+	int32_t drop = t_prev - t;
+	if (t_prev > 0 && drop >= min_drop && t < t_set)		// The tip is losing heat, i.e. touches the massive part
+		ff += ((int32_t)capacity() * drop) >> 4;
+	return ff;
+}
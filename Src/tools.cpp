@@ -6,6 +6,9 @@
  *
  *  Sep 09 2023, v 1.03
  *  	Added emap(): Extended map. value can be greater than v_max or less than v_min; emap() return value can be less than r_min or greater than r_max
+ *  Oct 16 2026, v 1.13
+ *  	Added isqrt(): integer square root, allows to avoid double precision arithmetic
+ *  	Added crc32(): the CRC-32 (IEEE 802.3) checksum of the data block
  */
 
 #include "tools.h"
@@ -38,6 +41,38 @@ uint8_t gauge(uint8_t percent, uint8_t p_middle, uint8_t g_max) {
 	}
 }
 
+// Integer square root (floor) by the bit-by-bit method
+uint32_t isqrt(uint64_t value) {
+	uint64_t res = 0;
+	uint64_t bit = (uint64_t)1 << 62;						// The highest power of four
+	while (bit > value) bit >>= 2;
+	while (bit) {
+		if (value >= res + bit) {
+			value -= res + bit;
+			res = (res >> 1) + bit;
+		} else {
+			res >>= 1;
+		}
+		bit >>= 2;
+	}
+	return res;
+}
+
+/*
+ * CRC-32 (IEEE 802.3, reflected polynomial 0xEDB88320) of the data block. The crc is the result of the previous block,
+ * so the checksum of several blocks can be calculated: start with crc = 0
+ */
+uint32_t crc32(const void *data, uint32_t size, uint32_t crc) {
+	const uint8_t *p = (const uint8_t *)data;
+	crc = ~crc;
+	while (size--) {
+		crc ^= *p++;
+		for (uint8_t i = 0; i < 8; ++i)
+			crc = (crc >> 1) ^ (0xEDB88320U & (0U - (crc & 1)));
+	}
+	return ~crc;
+}
+
 // Arduino constrain() function: limits the value inside the required interval
 int32_t constrain(int32_t value, int32_t min, int32_t max) {
 	if (value < min)	return min;
@@ -26,6 +26,9 @@
  * 		Modified the MWORK::loop() and MWORK::manageEncoders() to save the preset temperature after save_preset_to timeout the encoder was rotated
  *  2025 NOV 03, v.1.12
  *  	Modified MWORK::manageEncoders() to correctly manage fan speed in percents
+ *  2026 OCT 16, v.1.13
+ *  	MWORK::init() loads the learned tip thermal models into the IRONs, the models are saved when the IRON is turned-off
+ *  	MWORK::loop() redraws the status with the rate defined by the refresh governor (see refresh.h)
  */
 
 #include "work_mode.h"
@@ -52,6 +55,8 @@ void MWORK::init(void) {
 	temp_i			= pCFG->humanToTemp(temp, ambient, d_gun);
 	pCore->hotgun.setTemp(temp_i);
 	pD->drawAmbient(ambient, pCFG->isCelsius());
+	pCore->t12.setModel(pCFG->heatCapacity(d_t12), pCFG->heatLoss(d_t12));
+	pCore->jbc.setModel(pCFG->heatCapacity(d_jbc), pCFG->heatLoss(d_jbc));
 
 	DASH::init();
 	if (start && !not_t12 && pCFG->isAutoStart()) {			// The T12 IRON can be started just after power-on. Default DASH mode is DM_T12_GUN
@@ -75,6 +80,7 @@ void MWORK::init(void) {
 	return_to_temp	= 0;
 	gun_switch_off	= 0;
 	pD->clear();
+	pCore->refresh.start();									// Measure the frame rate of the dashboard only
 	initDevices(true, true);
 	if (!not_t12)
 		pCore->t12.setCheckPeriod(6);						// Start checking the current through T12 IRON
@@ -102,7 +108,13 @@ MODE* MWORK::loop(void) {
 	}
 	animateFan();											// Draw the fan animated icon. The color depends on the Gun temperature
 
-    if (HAL_GetTick() < update_screen) return this;
+	if (update_screen == 0)									// The screen redraw forced by the user action
+		pCore->refresh.activity();
+    if (HAL_GetTick() < update_screen) {
+    	if (pCore->refresh.frame())							// Redraw the status between the logic steps when the values change fast
+    		drawStatus(t12_phase, jbc_phase, ambient);
+    	return this;
+    }
     update_screen = HAL_GetTick() + period;
 
 	if (t12_phase_end > 0 && HAL_GetTick() >= t12_phase_end) {
@@ -199,7 +211,12 @@ MODE* MWORK::loop(void) {
 	}
 
 	adjustPresetTemp();
-	drawStatus(t12_phase, jbc_phase, ambient);
+	UNIT*	pUU = (u_dev == d_t12)?pT12:pJBC;
+	UNIT*	pLU	= (l_dev == d_t12)?(UNIT*)pT12:(UNIT*)pHG;
+	pCore->refresh.watch(0, pUU->averageTemp(), pUU->tmpDispersion());
+	pCore->refresh.watch(1, pLU->averageTemp(), pLU->tmpDispersion());
+	if (pCore->refresh.frame())
+		drawStatus(t12_phase, jbc_phase, ambient);
 
 	// Check to save preset temperature
 	if (enc_changed_ms > 0 && enc_changed_ms + save_preset_to <= HAL_GetTick()) {
@@ -209,6 +226,11 @@ MODE* MWORK::loop(void) {
 	return this;
 }
 
+void MWORK::saveTipModels(void) {
+	pCore->cfg.saveTipModel(d_t12, pCore->t12.heatCapacity(), pCore->t12.heatLoss());
+	pCore->cfg.saveTipModel(d_jbc, pCore->jbc.heatCapacity(), pCore->jbc.heatLoss());
+}
+
 // Check the hardware switches: REED switch of the Hot Air Gun and STANDBY switch of JBC iron. Returns True if the switch status changed
 void MWORK::manageHardwareSwitches(CFG* pCFG, IRON *pT12, IRON *pJBC, HOTGUN *pHG) {
 	bool no_t12 = no_ambient && !pT12->isConnected() && !is_extra_tip;	// The T12 iron handle is not connected flag: no ambient sensor, no current through the iron and no extra tip
@@ -306,6 +328,7 @@ void MWORK::manageHardwareSwitches(CFG* pCFG, IRON *pT12, IRON *pJBC, HOTGUN *pH
 			}
 			disableJBC();
 			pCFG->saveConfig();								// Save configuration when the JBC IRON is turned-off
+			saveTipModels();
 			update_screen	= 0;
 		}
 		not_jbc = false;									// Re-enable JBC iron
@@ -396,6 +419,7 @@ void MWORK::t12PhaseEnd(void) {
 			pCore->t12.switchPower(false);
 			presetTemp(d_t12, t); 							// redraw actual temperature
 			pCore->cfg.saveConfig();						// Save configuration when the T12 IRON is turned-off
+			saveTipModels();
 			break;
 		case IRPH_COLD:
 			t12_phase = IRPH_OFF;
@@ -421,6 +445,7 @@ void MWORK::jbcPhaseEnd(void) {
 			pCore->jbc.switchPower(false);
 			presetTemp(d_jbc, t);							// redraw actual temperature
 			pCore->cfg.saveConfig();						// Save configuration when the JBC IRON is turned-off
+			saveTipModels();
 			break;
 		case IRPH_COLD:
 			jbc_phase = IRPH_OFF;
@@ -650,6 +675,7 @@ void MWORK::t12PressShort(void) {
 			t12_phase	= IRPH_COOLING;
 			ironPhase(d_t12, t12_phase);
 			pCore->cfg.saveConfig();						// Save configuration when the T12 IRON is turned-off
+			saveTipModels();
 			presetTemp(d_t12, pCore->cfg.tempPresetHuman(d_t12));
 			break;
 	}
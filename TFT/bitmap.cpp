@@ -43,7 +43,7 @@ BITMAP::BITMAP(uint8_t* addr, uint32_t max_size, uint16_t width, uint16_t height
 
 BITMAP::BITMAP(const BITMAP &bm) {
 	this->ds = bm.ds;
-	++ds->links;
+	if (ds) ++ds->links;
 }
 
 BITMAP&	BITMAP::operator=(const BITMAP &bm) {
@@ -52,7 +52,7 @@ BITMAP&	BITMAP::operator=(const BITMAP &bm) {
 			free(ds);
 		}
 		this->ds = bm.ds;
-		++ds->links;
+		if (ds) ++ds->links;
 	}
 	return *this;
 }
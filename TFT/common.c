@@ -5,6 +5,10 @@
  *      Author: Alex
  *
  *  Modified May 22, 2024
+ *  Modified Oct 16, 2026
+ *  	Added TFT_DrawBitmapPart() to redraw the changed part of the bitmap only
+ *  	The bitmap drawing routines send the runs of identical pixels by single TFT_ColorBlockSend() call, see TFT_BitmapSpan()
+ *  	Added TFT_DrawPixmapPart() to redraw the changed part of the pixmap only
  */
 
 #include "ll_spi.h"
@@ -17,6 +21,7 @@ static void		TFT_DrawCircleHelper(uint16_t x0, uint16_t y0, uint16_t r, uint8_t
 static void 	TFT_DrawFilledCircleHelper(uint16_t x0, uint16_t y0, uint16_t r, uint8_t cornername, uint16_t delta, uint16_t color);
 static void 	swap16(uint16_t* a, uint16_t* b);
 static void 	swap32(int32_t*  a, int32_t* b);
+static void		TFT_BitmapSpan(const uint8_t *line, uint16_t bit, uint16_t length, uint16_t bg_color, uint16_t fg_color);
 
 // Width & Height of the display used to draw elements (with rotation)
 static uint16_t				TFT_WIDTH		= 0;
@@ -576,18 +581,10 @@ void TFT_DrawBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area
 	TFT_StartDrawArea(x0, y0, area_width, area_height);
 
 	uint16_t bytes_per_row = (bm_width + 7) >> 3;
+	uint16_t out_bit = (bm_width < area_width)?bm_width:area_width;	// Number of bits to be pushed out from the bitmap row
 	// Write color data row by row
     for (uint16_t row = 0; row < area_height; ++row) {
-    	uint16_t out_bit  = 0;					// Number of bits were pushed out
-    	for (uint16_t bit = 0; bit < bm_width; ++bit) {
-			if (out_bit >= area_width)			// row is over
-				break;
-			uint16_t in_byte = row * bytes_per_row + (bit >> 3);
-			uint8_t  in_mask = 0x80 >> (bit & 0x7);
-			uint16_t color 	 = (in_mask & bitmap[in_byte])?fg_color:bg_color;
-			TFT_ColorBlockSend(color, 1);
-			++out_bit;
-    	}
+    	TFT_BitmapSpan(&bitmap[row * bytes_per_row], 0, out_bit, bg_color, fg_color);
     	// Fill-up rest area with background color
     	if (area_width > out_bit) {
     		TFT_ColorBlockSend(bg_color, area_width - out_bit);
@@ -597,6 +594,26 @@ void TFT_DrawBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area
     TFT_FinishDrawArea();						// Flush color block buffer
 }
 
+// Draw the rectangular part of the bitmap starting at (part_x, part_y). The top-left corner of the part is drawn at (x0, y0)
+void TFT_DrawBitmapPart(uint16_t x0, uint16_t y0, const uint8_t *bitmap, uint16_t bm_width, uint16_t bm_height,
+		uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height, uint16_t bg_color, uint16_t fg_color) {
+
+	if (!bitmap || part_x >= bm_width || part_y >= bm_height || part_width < 1 || part_height < 1) return;
+	if (part_x + part_width  > bm_width)  part_width  = bm_width  - part_x;
+	if (part_y + part_height > bm_height) part_height = bm_height - part_y;
+	if (x0 >= TFT_WIDTH || y0 >= TFT_HEIGHT) return;
+	if (x0 + part_width  > TFT_WIDTH)  part_width  = TFT_WIDTH  - x0;
+	if (y0 + part_height > TFT_HEIGHT) part_height = TFT_HEIGHT - y0;
+
+	TFT_StartDrawArea(x0, y0, part_width, part_height);
+
+	uint16_t bytes_per_row = (bm_width + 7) >> 3;
+	for (uint16_t row = part_y; row < part_y + part_height; ++row) {
+		TFT_BitmapSpan(&bitmap[row * bytes_per_row], part_x, part_width, bg_color, fg_color);
+	}
+	TFT_FinishDrawArea();						// Flush color block buffer
+}
+
 // Draw bitmap created from the string.
 void TFT_DrawScrolledBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height,
 		const uint8_t *bitmap, uint16_t bm_width, int16_t offset, uint8_t gap, uint16_t bg_color, uint16_t fg_color) {
@@ -620,15 +637,14 @@ void TFT_DrawScrolledBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint1
     	}
     	int16_t bitmap_offset = offset;				// The bitmap offset is actual on the first while() loop only
     	while (out_bit < area_width) {				// The bitmap can fit the region several times
-			for (uint16_t bit = (bitmap_offset > 0)?bitmap_offset:0; bit < bm_width; ++bit) {
-				if (out_bit >= area_width)			// row is over
-					break;
-				uint16_t in_byte = row * bytes_per_row + (bit >> 3);
-				uint8_t  in_mask = 0x80 >> (bit & 0x7);
-				uint16_t color 	 = (in_mask & bitmap[in_byte])?fg_color:bg_color;
-				TFT_ColorBlockSend(color, 1);
-				++out_bit;
-			}
+    		uint16_t bit = (bitmap_offset > 0)?bitmap_offset:0;
+    		if (bit < bm_width) {
+    			uint16_t length = bm_width - bit;
+    			if (length > area_width - out_bit)	// row is over
+    				length = area_width - out_bit;
+    			TFT_BitmapSpan(&bitmap[row * bytes_per_row], bit, length, bg_color, fg_color);
+    			out_bit += length;
+    		}
 			bitmap_offset = 0;						// The bitmap offset is actual on the first while() loop only
 			if (gap == 0) {							// Not looped bitmap. Fill-up rest area with background color
 				if (area_width > out_bit)
@@ -648,6 +664,31 @@ void TFT_DrawScrolledBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint1
     TFT_FinishDrawArea();									// Flush color block buffer
 }
 
+/*
+ * Send the part of the bitmap row to the display: "length" pixels starting from "bit"
+ * The runs of identical pixels are sent by single TFT_ColorBlockSend() call, the whole 0x00 or 0xFF bytes are checked at once
+ */
+static void TFT_BitmapSpan(const uint8_t *line, uint16_t bit, uint16_t length, uint16_t bg_color, uint16_t fg_color) {
+	uint16_t end = bit + length;
+	while (bit < end) {
+		uint8_t  on  = (line[bit >> 3] << (bit & 0x7)) & 0x80;
+		uint8_t  all = on?0xFF:0x00;				// The byte value of the whole run byte
+		uint16_t run = bit;
+		while (run < end) {
+			uint8_t b = line[run >> 3];
+			if ((run & 0x7) == 0 && run + 8 <= end && b == all) {
+				run += 8;
+				continue;
+			}
+			if (((b << (run & 0x7)) & 0x80) != on)
+				break;
+			++run;
+		}
+		TFT_ColorBlockSend(on?fg_color:bg_color, run - bit);
+		bit = run;
+	}
+}
+
 // Draw pixmap
 void TFT_DrawPixmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height,
 		const uint8_t *pixmap, uint16_t pm_width, uint8_t depth, uint16_t palette[]) {
@@ -692,6 +733,44 @@ void TFT_DrawPixmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area
     TFT_FinishDrawArea();									// Flush color block buffer
 }
 
+// Draw the rectangular part of the pixmap starting at (part_x, part_y). The top-left corner of the part is drawn at (x0, y0)
+void TFT_DrawPixmapPart(uint16_t x0, uint16_t y0, const uint8_t *pixmap, uint16_t pm_width, uint16_t pm_height, uint8_t depth, uint16_t palette[],
+		uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height) {
+
+	if (!pixmap || part_x >= pm_width || part_y >= pm_height || part_width < 1 || part_height < 1) return;
+	if (part_x + part_width  > pm_width)  part_width  = pm_width  - part_x;
+	if (part_y + part_height > pm_height) part_height = pm_height - part_y;
+	if (x0 >= TFT_WIDTH || y0 >= TFT_HEIGHT) return;
+	if (x0 + part_width  > TFT_WIDTH)  part_width  = TFT_WIDTH  - x0;
+	if (y0 + part_height > TFT_HEIGHT) part_height = TFT_HEIGHT - y0;
+
+	TFT_StartDrawArea(x0, y0, part_width, part_height);
+
+	uint16_t bytes_per_row	= (pm_width*depth + 7) >> 3;
+	uint16_t code_mask		= (1 << depth) - 1;
+	uint16_t color			= 0;
+	uint32_t run			= 0;							// The number of the pixels of the same color to be sent
+	for (uint16_t row = part_y; row < part_y + part_height; ++row) {
+		const uint8_t *line = &pixmap[row * bytes_per_row];
+		for (uint16_t px = part_x; px < part_x + part_width; ++px) {
+			uint32_t bit	= px * depth;
+			uint16_t word	= line[bit >> 3] << 8;
+			if ((bit & 0x7) + depth > 8)					// The color code crosses the byte boundary
+				word |= line[(bit >> 3) + 1];
+			uint16_t c = palette[(word >> (16 - depth - (bit & 0x7))) & code_mask];
+			if (run > 0 && c != color) {
+				TFT_ColorBlockSend(color, run);
+				run = 0;
+			}
+			color = c;
+			++run;
+		}
+	}
+	if (run > 0)
+		TFT_ColorBlockSend(color, run);
+	TFT_FinishDrawArea();									// Flush color block buffer
+}
+
 void TFT_Touch_Adjust_Rotation_XY(uint16_t *x, uint16_t *y) {
 	int16_t X = *x;
 	int16_t Y = *y;
@@ -95,10 +95,14 @@ void		TFT_BM_JoinIcon(uint8_t *bitmap, uint16_t bm_width, uint16_t bm_height, ui
 void		TFT_BM_DrawVGauge(uint8_t *bitmap, uint16_t bm_width, uint16_t bm_height, uint16_t gauge, uint8_t edged);
 void		TFT_DrawBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height,
 				const uint8_t *bitmap, uint16_t bm_width, uint16_t bg_color, uint16_t fg_color);
+void		TFT_DrawBitmapPart(uint16_t x0, uint16_t y0, const uint8_t *bitmap, uint16_t bm_width, uint16_t bm_height,
+				uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height, uint16_t bg_color, uint16_t fg_color);
 void		TFT_DrawScrolledBitmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height,
 				const uint8_t *bitmap, uint16_t bm_width, int16_t offset, uint8_t gap, uint16_t bg_color, uint16_t fg_color);
 void 		TFT_DrawPixmap(uint16_t x0, uint16_t y0, uint16_t area_width, uint16_t area_height,
 				const uint8_t *pixmap, uint16_t pm_width, uint8_t depth, uint16_t palette[]);
+void		TFT_DrawPixmapPart(uint16_t x0, uint16_t y0, const uint8_t *pixmap, uint16_t pm_width, uint16_t pm_height, uint8_t depth,
+				uint16_t palette[], uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height);
 void		TFT_DrawThickLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, uint8_t thickness, uint16_t color);
 void		TFT_DrawVarThickLine(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1, LineThickness thickness, uint16_t color);
 
@@ -35,6 +35,9 @@ extern SPI_HandleTypeDef 	TFT_SPI_PORT;
 // Works with NT35510 and SSD1963 displays
 #define APPLY_GAMMA_PROFILE	(1)
 
+// The number of decoded glyphs kept in the u8g2 glyph cache (see u8g_font.c). Comment out the next line to disable the cache
+#define TFT_GLYPH_CACHE		(16)
+
 #define		TFT_Delay(a)	HAL_Delay(a);
 
 #endif				// _TFT_CONFIG_H
@@ -3,12 +3,18 @@
  *
  *  Created on: 4 Nov 2022
  *      Author: Alex
+ *
+ *  Modified Oct 16, 2026
+ *  	Added TFT_ColorArraySend() to send the array of colors (picture line) by single call
  */
 
 #include "config.h"
 #include "interface.h"
 #include "common.h"
 
+// Forward function declaration
+static void IFACE_ColorArraySend(const uint16_t *colors, uint32_t size);
+
 // Hardware specific low-level function used to work with the display depending on the display interface type
 #ifdef TFT_SPI_PORT
 static t_TFT_Reset				pReset				= TFT_SPI_Reset;
@@ -19,6 +25,7 @@ static t_TFT_Color_Block_Init	pColorBlockInit		= TFT_SPI_ColorBlockInit;
 static t_TFT_Color_Block_Send	pColorBlockSend		= TFT_SPI_ColorBlockSend_16bits;
 static t_TFT_Color_Block_Flush	pColorBlockFlush	= TFT_SPI_ColorBlockFlush;
 static t_TFT_Draw_Pixel			pDrawPixel			= TFT_DrawPixel_16bits;
+static t_TFT_Color_Array_Send	pColorArraySend		= TFT_SPI_ColorArraySend_16bits;
 
 // SPI Interface
 void TFT_InterfaceSetup(tTFT_PIXEL_BITS data_size, tTFT_INT_FUNC *pINT) {
@@ -31,13 +38,16 @@ void TFT_InterfaceSetup(tTFT_PIXEL_BITS data_size, tTFT_INT_FUNC *pINT) {
 		pColorBlockFlush	= (pINT->pColorBlockFlush)?pINT->pColorBlockFlush:TFT_SPI_ColorBlockFlush;
 		if (data_size == TFT_16bits) {
 			pColorBlockSend	= (pINT->pColorBlockSend)?pINT->pColorBlockSend:TFT_SPI_ColorBlockSend_16bits;
+			pColorArraySend	= (pINT->pColorBlockSend)?IFACE_ColorArraySend:TFT_SPI_ColorArraySend_16bits;
 			pDrawPixel		= (pINT->pDrawPixel)?pINT->pDrawPixel:TFT_DrawPixel_16bits;
 		} else {
 			pColorBlockSend	= (pINT->pColorBlockSend)?pINT->pColorBlockSend:TFT_SPI_ColorBlockSend_18bits;
+			pColorArraySend	= (pINT->pColorBlockSend)?IFACE_ColorArraySend:TFT_SPI_ColorArraySend_18bits;
 			pDrawPixel		= (pINT->pDrawPixel)?pINT->pDrawPixel:TFT_DrawPixel_18bits;
 		}
 	} else {
 		pColorBlockSend		=	(data_size == TFT_16bits)?TFT_SPI_ColorBlockSend_16bits:TFT_SPI_ColorBlockSend_18bits;
+		pColorArraySend		=	(data_size == TFT_16bits)?TFT_SPI_ColorArraySend_16bits:TFT_SPI_ColorArraySend_18bits;
 		pDrawPixel			=	(data_size == TFT_16bits)?TFT_DrawPixel_16bits:TFT_DrawPixel_18bits;
 	}
 }
@@ -52,6 +62,7 @@ static t_TFT_Color_Block_Init	pColorBlockInit		= TFT_FSMC_ColorBlockInit;
 static t_TFT_Color_Block_Send	pColorBlockSend		= TFT_FSMC_ColorBlockSend_16bits;
 static t_TFT_Color_Block_Flush	pColorBlockFlush	= TFT_FSMC_ColorBlockFlush;
 static t_TFT_Draw_Pixel			pDrawPixel			= TFT_DrawPixel_16bits;
+static t_TFT_Color_Array_Send	pColorArraySend		= IFACE_ColorArraySend;
 
 // FSMC Interface
 void TFT_InterfaceSetup(tTFT_PIXEL_BITS data_size, tTFT_INT_FUNC *pINT) {
@@ -92,6 +103,24 @@ void TFT_ColorBlockSend(uint16_t color, uint32_t size) {
 	(*pColorBlockSend)(color, size);
 }
 
+void TFT_ColorArraySend(const uint16_t *colors, uint32_t size) {
+	(*pColorArraySend)(colors, size);
+}
+
+// Send the array of colors by the color block function, the runs of the same color are sent by single call
+static void IFACE_ColorArraySend(const uint16_t *colors, uint32_t size) {
+	while (size > 0) {
+		uint16_t color	= *colors++;
+		uint32_t run	= 1;
+		while (run < size && *colors == color) {
+			++colors;
+			++run;
+		}
+		(*pColorBlockSend)(color, run);
+		size -= run;
+	}
+}
+
 void TFT_FinishDrawArea(void) {
 	(*pColorBlockFlush)();								// Flush color block buffer
 }
@@ -22,6 +22,7 @@ typedef void		(*t_TFT_Color_Block_Init)(void);
 typedef void		(*t_TFT_Color_Block_Send)(uint16_t color, uint32_t size);
 typedef void		(*t_TFT_Color_Block_Flush)(void);
 typedef void 		(*t_TFT_Draw_Pixel)(uint16_t x,  uint16_t y, uint16_t color);
+typedef void		(*t_TFT_Color_Array_Send)(const uint16_t *colors, uint32_t size);
 
 typedef struct {
 	t_TFT_Reset				pReset;
@@ -49,6 +50,7 @@ void		TFT_InterfaceSetup(tTFT_PIXEL_BITS data_size, tTFT_INT_FUNC *pINT);
 // Interface functions
 void		TFT_Command(uint8_t cmd, const uint8_t* buff, size_t buff_size);
 void		TFT_ColorBlockSend(uint16_t color, uint32_t size);
+void		TFT_ColorArraySend(const uint16_t *colors, uint32_t size);
 void		TFT_FinishDrawArea();
 bool 		TFT_ReadData(uint8_t cmd, uint8_t *data, uint16_t size);
 void 		TFT_DrawPixel_16bits(uint16_t x,  uint16_t y, uint16_t color);
@@ -3,14 +3,23 @@
  *
  *  Created on: Nov 16 2020
  *      Author: Alex
+ *
+ *  Modified Oct 16, 2026
+ *  	The DMA color data transfer uses the queue of segments, the CPU does not wait for the last segment has been sent
+ *  	Added TFT_SPI_ColorArraySend_16bits() and TFT_SPI_ColorArraySend_18bits() to send the array of colors converting it into the segment directly
+ *  	The color data is converted into the display format by the pixel kernels, see pixel.h
+ *  	Added TFT_SPI_BusBytes() and TFT_SPI_BitRate() to measure the SPI bus utilization
  */
 #include "ll_spi.h"
+#include "pixel.h"
 
 #ifdef TFT_SPI_PORT
 
 #define BURST_HALF_SIZE 		(768)			// Divided by 2 and 3 for any pixel format: 3 bytes or 2 bytes per pixel
-static uint8_t	buff[BURST_HALF_SIZE*2];		// Buffer to be send via SPI
 static uint16_t index = 0;						// Buffer index to put new data
+static uint32_t bus_bytes = 0;					// The number of bytes sent to the display, changed in main loop only
+
+static void TFT_SPI_WaitIdle(void);
 
 // Activates process of sending a command to the display, chip select goes to low state
 static void TFT_SPI_Select(void) {
@@ -38,6 +47,7 @@ static void TFT_SPI_COMMAND_MODE(void) {
 
 // HARDWARE RESET
 void TFT_SPI_Reset(void) {
+	TFT_SPI_WaitIdle();
 	TFT_SPI_RST(GPIO_PIN_RESET);
 	TFT_Delay(200);
 	TFT_SPI_Select();
@@ -54,10 +64,13 @@ void TFT_SPI_DATA_MODE(void) {
 
 // Send command (byte) to the Display followed by the command arguments
 void TFT_SPI_Command(uint8_t cmd, const uint8_t* buff, size_t buff_size) {
+	TFT_SPI_WaitIdle();								// The queued color data should be sent before the DC pin changed
 	TFT_SPI_COMMAND_MODE();
 	HAL_SPI_Transmit(&TFT_SPI_PORT, &cmd, 1, 10);
 	TFT_SPI_Unselect();
+	++bus_bytes;
 	if (buff && buff_size > 0) {
+		bus_bytes += buff_size;
 		TFT_SPI_DATA_MODE();
 		while (buff_size > 0) {
 			uint16_t chunk_size = buff_size > 32768 ? 32768 : buff_size;
@@ -72,158 +85,261 @@ void TFT_SPI_Command(uint8_t cmd, const uint8_t* buff, size_t buff_size) {
 bool TFT_SPI_ReadData(uint8_t cmd, uint8_t *data, uint16_t size) {
 	if (!data || size == 0) return 0;
 
+	TFT_SPI_WaitIdle();
 	TFT_SPI_COMMAND_MODE();
 	HAL_SPI_Transmit(&TFT_SPI_PORT, &cmd, 1, 10);
 	bool ret = (HAL_OK == HAL_SPI_Receive(&TFT_SPI_PORT, data, size, 100));
 	TFT_SPI_Unselect();
+	bus_bytes += size + 1;
 	return ret;
 }
 
+uint32_t TFT_SPI_BusBytes(void) {
+	return bus_bytes;
+}
+
+// The SPI bus bit rate: the APB clock of the SPI port divided by the baud rate prescaler, 2^(BR+1)
+uint32_t TFT_SPI_BitRate(void) {
+	SPI_TypeDef *spi	= TFT_SPI_PORT.Instance;
+	uint32_t	 pclk	= HAL_RCC_GetPCLK1Freq();		// SPI2 and SPI3 are clocked by APB1
+	if (spi == SPI1
+#ifdef SPI4
+		|| spi == SPI4
+#endif
+		) {
+		pclk = HAL_RCC_GetPCLK2Freq();
+	}
+	uint32_t br = (spi->CR1 & SPI_CR1_BR) >> SPI_CR1_BR_Pos;
+	return pclk >> (br + 1);
+}
+
 // Last section of this file dedicated to send block of color(s) to the display via SPI bus
 
 #ifdef TFT_USE_DMA
 /*
  * Send color buffer with DMA support enabled via SPI bus
- * Split buff into two pieces but use normal DMA buffer
- * Each half-buffer sending separately using DMA
- * Active sending half-buffer indexed by buff_sending variable
- * 0 or 1 means low or upper half-buffer is sending via DMA, 2 means no active buffer sending
- * buff_border variable indicating the top limit of the current half-buffer
- * that is filling by new data to be sent.
- * When low half-buffer is filling, the buff_border is equal to BURST_HALF_SIZE,
- * when upper half-buffer if fiiling, the buff_border is equal to BURST_HALF_SIZE*2
+ * The color data is written into the queue of DMA_SEGMENTS segments, BURST_HALF_SIZE bytes each.
+ * The segment filled up completely is put into the queue and the DMA sends the queued segments one by one in the background:
+ * the next segment transfer is started by the transfer complete callback. The CPU waits only if all the segments are queued.
+ * TFT_SPI_ColorBlockFlush() queues the last segment and returns immediately, the chip select goes high when the queue is empty.
+ * So the CPU prepares the next drawing while the DMA sends the previous one. The display command waits for the queue to be empty,
+ * because it changes the DC pin state (see TFT_SPI_WaitIdle())
+ * Active sending segment indexed by q_head variable, q_count is the number of queued segments, including the sending one.
+ * The CPU fills the segment indexed by q_tail.
  */
 
-static volatile uint8_t 	buff_sending	= 2;// Index of the sending via DMA buffer (0 or 1). If Greater than 1, DMA is in idle state.
-static uint16_t	buff_border					= BURST_HALF_SIZE; // We can write data to the buffer until this boundary
+#define DMA_SEGMENTS			(4)
+static uint8_t				seg_buff[DMA_SEGMENTS][BURST_HALF_SIZE];
+static uint16_t				seg_len[DMA_SEGMENTS];
+static volatile uint8_t		q_head			= 0;		// The segment is sending via DMA now
+static volatile uint8_t		q_count			= 0;		// The number of the queued segments
+static uint8_t				q_tail			= 0;		// The segment is filling by the CPU
+static volatile bool		unselect_idle	= false;	// Unselect the display when the queue becomes empty
+
+static void startSegment(void) {
+	HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, seg_buff[q_head], seg_len[q_head]);
+}
 
-// Complete buffer sent callback procedure
+// Complete segment sent callback procedure, start sending the next queued segment
 void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef *hspi) {
-		buff_sending = 2;						// DMA buffer sending is complete
+	if (hspi != &TFT_SPI_PORT) return;
+	if (q_count == 0) return;
+	q_head = (q_head + 1) % DMA_SEGMENTS;
+	if (--q_count > 0) {
+		startSegment();
+	} else if (unselect_idle) {
+		unselect_idle = false;
+		TFT_SPI_Unselect();
+	}
+}
+
+// Reset the queue, stop the DMA transfer
+static void resetQueue(void) {
+	HAL_SPI_DMAStop(&TFT_SPI_PORT);
+	q_head			= 0;
+	q_count			= 0;
+	q_tail			= 0;
+	index			= 0;
+	unselect_idle	= false;
 }
 
-static uint8_t waitHalfBuffer(uint32_t to) {
+// Wait till the number of queued segments is less than the limit
+static uint8_t waitQueue(uint8_t limit, uint32_t to) {
 	uint32_t finish_ms = HAL_GetTick() + to;
-	while (HAL_GetTick() < finish_ms) {
-		if (buff_sending > 1)					// The half-buffer was successfully sent
-			return 1;
+	while (q_count > limit) {
+		if (HAL_GetTick() >= finish_ms)
+			return 0;
+	}
+	return 1;
+}
+
+// Wait till all queued data has been sent
+static void TFT_SPI_WaitIdle(void) {
+	if (0 == waitQueue(0, 2000)) {					// Timed out
+		resetQueue();
+		TFT_SPI_Unselect();
 	}
-	return 0;
+}
+
+// Put the filled segment into the queue and start sending if the DMA is idle
+static uint8_t queueSegment(void) {
+	seg_len[q_tail]	= index;
+	bus_bytes		+= index;
+	index			= 0;
+	__disable_irq();
+	if (++q_count == 1)								// The DMA is idle
+		startSegment();
+	__enable_irq();
+	q_tail = (q_tail + 1) % DMA_SEGMENTS;
+	if (0 == waitQueue(DMA_SEGMENTS-1, 2000)) {		// Wait for the free segment to fill up
+		resetQueue();
+		return 0;									// Transfer failed
+	}
+	return 1;
 }
 
 // Prepare to send new data block
 void TFT_SPI_ColorBlockInit(void) {
-	if (buff_sending <= 1) {					// There is an active DMA transfer
-		waitHalfBuffer(2000);
-		HAL_SPI_DMAStop(&TFT_SPI_PORT);
-	}
-	buff_border		= BURST_HALF_SIZE;
+	TFT_SPI_WaitIdle();
 	index			= 0;
-	buff_sending	= 2;
+	unselect_idle	= false;
 }
 
 void TFT_SPI_ColorBlockSend_18bits(uint16_t color, uint32_t size) {
-	// Convert to 18-bits color
-	uint8_t r = (color & 0xF800) >> 8;
-	uint8_t g = (color & 0x7E0)  >> 3;
-	uint8_t b = (color & 0x1F)   << 3;
-	for (uint32_t i = 0; i < size; ++i) {
-		buff[index++] = r;
-		buff[index++] = g;
-		buff[index++] = b;
-		if (index >= buff_border) {				// The half-buffer filled completely
-			if (0 == waitHalfBuffer(2000)) {	// Timed out
-				TFT_SPI_ColorBlockInit();
-				return;							// Transfer failed
-			}
-			if (buff_border <= BURST_HALF_SIZE) {
-				buff_border <<= 1;				// BURST_HALF_SIZE*2
-				buff_sending = 0;				// First half buffer start sending data
-				HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, (uint8_t *)buff, BURST_HALF_SIZE);
-			} else {
-				buff_border = BURST_HALF_SIZE;
-				index = 0;
-				buff_sending = 1;				// Second half buffer start sending data
-				HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, (uint8_t *)(buff+BURST_HALF_SIZE), BURST_HALF_SIZE);
-			}
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE - index) / 3;	// The number of pixels the segment can hold
+		if (n > size) n = size;
+		TFT_Fill666(&seg_buff[q_tail][index], color, n);
+		index	+= n * 3;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE) {				// The segment filled completely
+			if (0 == queueSegment())
+				return;
 		}
 	}
 }
 
 void TFT_SPI_ColorBlockSend_16bits(uint16_t color, uint32_t size) {
-	for (uint32_t i = 0; i < size; ++i) {
-		buff[index++] = (color >> 8 ) & 0xFF;
-		buff[index++] = color & 0xFF;
-		if (index >= buff_border) {				// The half-buffer filled completely
-			if (0 == waitHalfBuffer(2000)) {	// Timed out
-				TFT_SPI_ColorBlockInit();
-				return;							// Transfer failed
-			}
-			if (buff_border <= BURST_HALF_SIZE) {
-				buff_border <<= 1;
-				buff_sending = 0;				// First half buffer start sending data
-				HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, (uint8_t *)buff, BURST_HALF_SIZE);
-			} else {
-				buff_border = BURST_HALF_SIZE;
-				index = 0;
-				buff_sending = 1;				// Second half buffer start sending data
-				HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, (uint8_t *)(buff+BURST_HALF_SIZE), BURST_HALF_SIZE);
-			}
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE - index) >> 1;	// The number of pixels the segment can hold
+		if (n > size) n = size;
+		TFT_Fill565(&seg_buff[q_tail][index], color, n);
+		index	+= n * 2;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE) {				// The segment filled completely
+			if (0 == queueSegment())
+				return;
 		}
 	}
 }
 
-//	No more data, flush the buffer
-void TFT_SPI_ColorBlockFlush(void) {
-	if (0 == waitHalfBuffer(2000)) {			// Timed out
-		TFT_SPI_ColorBlockInit();
-		return;									// Transfer failed
+// Convert the colors into the panel format directly in the segment, queue every filled segment
+void TFT_SPI_ColorArraySend_16bits(const uint16_t *colors, uint32_t size) {
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE - index) >> 1;	// The number of pixels the segment can hold
+		if (n > size) n = size;
+		TFT_Conv565(&seg_buff[q_tail][index], colors, n);
+		colors	+= n;
+		index	+= n * 2;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE) {				// The segment filled completely
+			if (0 == queueSegment())
+				return;
+		}
 	}
-	HAL_SPI_DMAStop(&TFT_SPI_PORT);
-	// Check the 'tail' bytes are in the buffer
-	uint8_t *hb = buff;
-	uint16_t bytes_to_send = index;
-	if (buff_border > BURST_HALF_SIZE) {
-		bytes_to_send -= BURST_HALF_SIZE;
-		hb += BURST_HALF_SIZE;
+}
+
+void TFT_SPI_ColorArraySend_18bits(const uint16_t *colors, uint32_t size) {
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE - index) / 3;	// The number of pixels the segment can hold
+		if (n > size) n = size;
+		TFT_Conv666(&seg_buff[q_tail][index], colors, n);
+		colors	+= n;
+		index	+= n * 3;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE) {				// The segment filled completely
+			if (0 == queueSegment())
+				return;
+		}
 	}
-	if (bytes_to_send > 0) {
-		buff_sending = 0;
-		HAL_SPI_Transmit_DMA(&TFT_SPI_PORT, hb, bytes_to_send);
-		waitHalfBuffer(2000);
+}
+
+//	No more data, queue the rest of data and do not wait the transfer finished
+void TFT_SPI_ColorBlockFlush(void) {
+	if (index > 0 && 0 == queueSegment())
+		return;										// Transfer failed
+	__disable_irq();
+	if (q_count > 0) {
+		unselect_idle = true;						// Unselect the display in HAL_SPI_TxCpltCallback()
+	} else {
+		TFT_SPI_Unselect();
 	}
-	TFT_SPI_ColorBlockInit();
-	TFT_SPI_Unselect();
+	__enable_irq();
 }
 
 
 #else 			// TFT_USE_DMA not defined
 // Send color buffer without DMA support via SPI bus
+static uint8_t	buff[BURST_HALF_SIZE*2];		// Buffer to be send via SPI
 
-void TFT_SPI_ColorBlockSend_18bits(uint16_t color, uint32_t size) {
-	// Convert to 18-bits color
-	uint8_t r = (color & 0xF800) >> 8;
-	uint8_t g = (color & 0x7E0)  >> 3;
-	uint8_t b = (color & 0x1F)   << 3;
-	for (uint32_t i = 0; i < size; ++i) {
-		buff[index++] = r;
-		buff[index++] = g;
-		buff[index++] = b;
+static void sendBuffer(uint16_t size) {
+	HAL_SPI_Transmit(&TFT_SPI_PORT, (uint8_t *)buff, size, 100);
+	bus_bytes += size;
+}
 
+void TFT_SPI_ColorBlockSend_18bits(uint16_t color, uint32_t size) {
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE*2 - index) / 3;	// The number of pixels the buffer can hold
+		if (n > size) n = size;
+		TFT_Fill666(&buff[index], color, n);
+		index	+= n * 3;
+		size	-= n;
 		if (index >= BURST_HALF_SIZE*2) {
-			HAL_SPI_Transmit(&TFT_SPI_PORT, (uint8_t *)buff, BURST_HALF_SIZE*2, 100);
+			sendBuffer(BURST_HALF_SIZE*2);
 			index = 0;
 		}
 	}
 }
 
 void TFT_SPI_ColorBlockSend_16bits(uint16_t color, uint32_t size) {
-	for (uint32_t i = 0; i < size; ++i) {
-		buff[index++] = (color >> 8) & 0xFF;
-		buff[index++] = color & 0xFF;
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE*2 - index) >> 1;	// The number of pixels the buffer can hold
+		if (n > size) n = size;
+		TFT_Fill565(&buff[index], color, n);
+		index	+= n * 2;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE*2) {
+			sendBuffer(BURST_HALF_SIZE*2);
+			index = 0;
+		}
+	}
+}
+
+void TFT_SPI_ColorArraySend_16bits(const uint16_t *colors, uint32_t size) {
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE*2 - index) >> 1;	// The number of pixels the buffer can hold
+		if (n > size) n = size;
+		TFT_Conv565(&buff[index], colors, n);
+		colors	+= n;
+		index	+= n * 2;
+		size	-= n;
+		if (index >= BURST_HALF_SIZE*2) {
+			sendBuffer(BURST_HALF_SIZE*2);
+			index = 0;
+		}
+	}
+}
 
+void TFT_SPI_ColorArraySend_18bits(const uint16_t *colors, uint32_t size) {
+	while (size > 0) {
+		uint32_t n = (BURST_HALF_SIZE*2 - index) / 3;	// The number of pixels the buffer can hold
+		if (n > size) n = size;
+		TFT_Conv666(&buff[index], colors, n);
+		colors	+= n;
+		index	+= n * 3;
+		size	-= n;
 		if (index >= BURST_HALF_SIZE*2) {
-			HAL_SPI_Transmit(&TFT_SPI_PORT, (uint8_t *)buff, BURST_HALF_SIZE*2, 100);
+			sendBuffer(BURST_HALF_SIZE*2);
 			index = 0;
 		}
 	}
@@ -231,12 +347,13 @@ void TFT_SPI_ColorBlockSend_16bits(uint16_t color, uint32_t size) {
 
 void TFT_SPI_ColorBlockFlush(void) {
 	if (index > 0)
-		HAL_SPI_Transmit(&TFT_SPI_PORT, (uint8_t *)buff, index, 100);
+		sendBuffer(index);
 	index = 0;
 	TFT_SPI_Unselect();
 }
 
 void TFT_SPI_ColorBlockInit(void) { }					// Not extra initialization required without DMA support
+static void TFT_SPI_WaitIdle(void) { }					// The data has been sent already
 
 #endif			// TFT_USE_DMA
 
@@ -27,7 +27,11 @@ bool		TFT_SPI_ReadData(uint8_t cmd, uint8_t *data, uint16_t size);
 void		TFT_SPI_ColorBlockInit(void);
 void		TFT_SPI_ColorBlockSend_16bits(uint16_t color, uint32_t size);
 void		TFT_SPI_ColorBlockSend_18bits(uint16_t color, uint32_t size);
+void		TFT_SPI_ColorArraySend_16bits(const uint16_t *colors, uint32_t size);
+void		TFT_SPI_ColorArraySend_18bits(const uint16_t *colors, uint32_t size);
 void		TFT_SPI_ColorBlockFlush(void);
+uint32_t	TFT_SPI_BusBytes(void);
+uint32_t	TFT_SPI_BitRate(void);
 
 #ifdef __cplusplus
 }
@@ -5,6 +5,9 @@
  *      Author: Alex
  *  2023 FEB 26
  *   Initialized *work with 0
+ *  2026 OCT 16
+ *   The JPEG blocks, BMP scanlines and regions are sent to the display by TFT_ColorArraySend() line by line.
+ *   The BMP scanline is converted to the display colors in place, the 16-bits BMP scanline is sent without conversion
  */
 
 #include "common.h"
@@ -19,6 +22,7 @@
 #include <stdlib.h>
 #include "ff.h"
 #include "tjpgd.h"
+#include "pixel.h"
 
 // BMP staff
 typedef struct {
@@ -37,6 +41,7 @@ static uint16_t u16min(uint16_t a, uint16_t b);
 static uint16_t read16(uint8_t *ptr);
 static uint32_t read32(uint8_t *ptr);
 static uint16_t readPixel(uint8_t *ptr, uint8_t bpp);
+static uint16_t *convertScanline(uint8_t *scanline, uint16_t w, uint8_t bpp);
 
 /*
  * The JPEG drawing routines based on TJpgDec - Tiny JPEG Decompressor
@@ -163,10 +168,7 @@ static uint16_t drawJpegBuffer(JDEC* jd, void *bitmap, JRECT* rect) {
 	uint16_t w = rect->right -  x + 1;			// rectangular area width
 	uint16_t h = rect->bottom - y + 1;			// rectangular area height
 	TFT_StartDrawArea(x, y, w, h);				// Set TFT address window to clipped image bounds
-	uint16_t *colors = (uint16_t *)bitmap;
-	for (uint32_t i = 0; i < h*w; ++i) {		// Send every pixel to the display
-		TFT_ColorBlockSend(*colors++, 1);
-	}
+	TFT_ColorArraySend((uint16_t *)bitmap, h*w);	// Send whole block to the display
 	TFT_FinishDrawArea();
 	return 1;
 }
@@ -200,9 +202,8 @@ static uint16_t clipJpegBuffer(JDEC* jd, void *bitmap, JRECT* rect) {
 	colors += bitmap_width * (is.top - rect->top);
 	for (uint16_t row = 0; row < h; ++row) {	// Send pixels row by row
 		colors += s_left;						// Skip left area of the bitmap
-		for (uint16_t p = 0; p < w; ++p)		// Send bitmap data into clipped area
-			TFT_ColorBlockSend(*colors++, 1);
-		colors += s_right;						// Skip right area of the bitmap
+		TFT_ColorArraySend(colors, w);			// Send bitmap data into clipped area
+		colors += w + s_right;					// Skip right area of the bitmap
 	}
 	TFT_FinishDrawArea();
 	return 1;
@@ -281,10 +282,8 @@ static bool drawBMPContent(FIL *bmp_file, BMP_INFO *bi, uint16_t x, uint16_t y,
 				TFT_FinishDrawArea();
 				return false;
 			}
-			for (uint32_t col = 0; col < w*bpp; col += bpp) { // For each pixel...
-				uint16_t color = readPixel(&scanline[col], bpp);
-				TFT_ColorBlockSend(color, 1);
-			}									// end pixel
+			// The display DMA sends the previous scanline while the next one is reading
+			TFT_ColorArraySend(convertScanline(scanline, w, bpp), w);
 		} else {								// Failed to allocate memory for scanline, read data by one pixel
 			for (uint32_t col = 0; col < w; ++col) { // For each pixel...
 				uint8_t clr[3];
@@ -585,15 +584,12 @@ void TFT_DrawRegion(uint16_t x, uint16_t y, uint16_t region[], uint16_t rw, uint
 		rh = TFT_Height() - y;
 	if (x + rw < TFT_Width()) {					// The whole region can fin the display
 		TFT_StartDrawArea(x, y, rw, rh);
-		for (uint32_t i = 0; i < rw * rh; ++i)
-			TFT_ColorBlockSend(region[i], 1);
+		TFT_ColorArraySend(region, rw * rh);
 	} else {
 		uint16_t area_width = TFT_Width() - x;	// Clip the region
 		TFT_StartDrawArea(x, y, area_width, rh);
 		for (uint16_t row = 0; row < rh; ++row) {
-			uint16_t row_pos = row * rw;
-			for (uint16_t col = 0; col < area_width; ++col)
-				TFT_ColorBlockSend(region[row_pos + col], 1);
+			TFT_ColorArraySend(&region[row * rw], area_width);
 		}
 	}
 	TFT_FinishDrawArea();
@@ -699,4 +695,12 @@ static uint16_t readPixel(uint8_t *ptr, uint8_t bpp) {
 	return ptr[1] << 8 | ptr[0];
 }
 
+// Convert the scanline to the array of 16-bits colors in place. The 16-bits R5-G6-B5 scanline is used as is (little endian)
+static uint16_t *convertScanline(uint8_t *scanline, uint16_t w, uint8_t bpp) {
+	uint16_t *colors = (uint16_t *)scanline;		// The scanline is allocated by malloc(), so it is aligned
+	if (bpp == 3)									// 24-bit color
+		TFT_Conv888to565(colors, scanline, w);
+	return colors;
+}
+
 #endif /* TFT_BMP_JPEG_ENABLE */
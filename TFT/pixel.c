@@ -0,0 +1,92 @@
+/*
+ * pixel.c
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The pixel format conversion kernels, see pixel.h
+ */
+
+#include <string.h>
+#include "pixel.h"
+
+#if defined(__ARM_FEATURE_DSP)
+#define PIX_REV16(x)	__REV16(x)
+#else
+#define PIX_REV16(x)	((((x) & 0x00FF00FFU) << 8) | (((x) >> 8) & 0x00FF00FFU))
+#endif
+
+// Swap bytes of both 16-bits colors of the word: two pixels in display byte order
+static inline uint32_t rev16(uint32_t x) {
+	return PIX_REV16(x);
+}
+
+void TFT_Fill565(uint8_t *dst, uint16_t color, uint32_t size) {
+	uint32_t pattern = rev16(((uint32_t)color << 16) | color);	// Two pixels
+	for (; size >= 2; size -= 2, dst += 4)
+		memcpy(dst, &pattern, 4);
+	if (size) {
+		dst[0] = color >> 8;
+		dst[1] = color & 0xFF;
+	}
+}
+
+/*
+ * Four pixels R6G6B6 take three words: R G B R, G B R G, B R G B
+ * The words are built once, then the buffer is filled by words
+ */
+void TFT_Fill666(uint8_t *dst, uint16_t color, uint32_t size) {
+	uint32_t r = (color & 0xF800) >> 8;
+	uint32_t g = (color & 0x7E0)  >> 3;
+	uint32_t b = (color & 0x1F)   << 3;
+	uint32_t pattern[3];
+	pattern[0] = r | (g << 8) | (b << 16) | (r << 24);
+	pattern[1] = g | (b << 8) | (r << 16) | (g << 24);
+	pattern[2] = b | (r << 8) | (g << 16) | (b << 24);
+	for (; size >= 4; size -= 4, dst += 12)
+		memcpy(dst, pattern, 12);
+	memcpy(dst, pattern, size * 3);
+}
+
+void TFT_Conv565(uint8_t *dst, const uint16_t *colors, uint32_t size) {
+	for (; size >= 2; size -= 2, colors += 2, dst += 4) {
+		uint32_t x;
+		memcpy(&x, colors, 4);								// Two pixels, the first one in the low half-word
+		x = rev16(x);
+		memcpy(dst, &x, 4);
+	}
+	if (size) {
+		dst[0] = *colors >> 8;
+		dst[1] = *colors & 0xFF;
+	}
+}
+
+/*
+ * Two pixels of the word are split into the color components at once: the first pixel components are in byte 0,
+ * the second pixel components are in byte 2 of each component word
+ */
+void TFT_Conv666(uint8_t *dst, const uint16_t *colors, uint32_t size) {
+	for (; size >= 2; size -= 2, colors += 2, dst += 6) {
+		uint32_t x;
+		memcpy(&x, colors, 4);
+		uint32_t r	= (x & 0xF800F800U) >> 8;
+		uint32_t g	= (x & 0x07E007E0U) >> 3;
+		uint32_t b	= (x & 0x001F001FU) << 3;
+		uint32_t w0	= (r & 0xFF) | ((g & 0xFF) << 8) | ((b & 0xFF) << 16) | ((r & 0xFF0000U) << 8);
+		uint16_t w1	= ((g >> 16) & 0xFF) | (((b >> 16) & 0xFF) << 8);
+		memcpy(dst, &w0, 4);
+		memcpy(dst+4, &w1, 2);
+	}
+	if (size) {
+		dst[0] = (*colors & 0xF800) >> 8;
+		dst[1] = (*colors & 0x7E0)  >> 3;
+		dst[2] = (*colors & 0x1F)   << 3;
+	}
+}
+
+// Every pixel is read before it is overwritten, so dst can be the same buffer as bgr
+void TFT_Conv888to565(uint16_t *dst, const uint8_t *bgr, uint32_t size) {
+	for (uint32_t i = 0; i < size; ++i, bgr += 3) {
+		uint16_t color = ((bgr[2] & 0xF8) << 8) | ((bgr[1] & 0xFC) << 3) | (bgr[0] >> 3);
+		dst[i] = color;
+	}
+}
@@ -0,0 +1,32 @@
+/*
+ * pixel.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The pixel format conversion kernels used to fill up the display data buffers.
+ *  The display expects the colors in big-endian byte order: R5G6B5 as 2 bytes or R6G6B6 as 3 bytes (the low bits of each byte are ignored).
+ *  The kernels process several pixels per 32-bit word (SIMD within a register). When compiled for the Cortex-M4 core
+ *  the DSP instructions are used, the portable C code is used otherwise and produces the same bytes.
+ *  The destination buffer can be unaligned. The kernels assume the little-endian core.
+ */
+
+#ifndef _PIXEL_H_
+#define _PIXEL_H_
+
+#include "main.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void		TFT_Fill565(uint8_t *dst, uint16_t color, uint32_t size);				// Fill-up the buffer with size pixels of the same color, 2 bytes per pixel
+void		TFT_Fill666(uint8_t *dst, uint16_t color, uint32_t size);				// Fill-up the buffer with size pixels of the same color, 3 bytes per pixel
+void		TFT_Conv565(uint8_t *dst, const uint16_t *colors, uint32_t size);		// Convert the array of colors, 2 bytes per pixel
+void		TFT_Conv666(uint8_t *dst, const uint16_t *colors, uint32_t size);		// Convert the array of colors, 3 bytes per pixel
+void		TFT_Conv888to565(uint16_t *dst, const uint8_t *bgr, uint32_t size);		// Convert B8G8R8 (BMP) pixels to the colors, can be done in place
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -198,3 +198,9 @@ void PIXMAP::draw(uint16_t x, uint16_t y, uint16_t area_width, uint16_t area_hei
 void PIXMAP::draw(uint16_t x, uint16_t y) {
 	TFT_DrawPixmap(x, y, ds->w, ds->h, ds->data, ds->w, ds->depth, palette());
 }
+
+// Draw the part of the pixmap only, (x, y) is the pixmap top-left corner on the screen
+void PIXMAP::drawPart(uint16_t x, uint16_t y, uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height) {
+	if (ds == 0) return;
+	TFT_DrawPixmapPart(x + part_x, y + part_y, ds->data, ds->w, ds->h, ds->depth, palette(), part_x, part_y, part_width, part_height);
+}
@@ -55,6 +55,7 @@ class PIXMAP {
 		void		drawVLine(uint16_t x, uint16_t y, uint16_t length, uint16_t color);
 		void		draw(uint16_t x, uint16_t y, uint16_t area_width, uint16_t area_height);
 		void		draw(uint16_t x, uint16_t y);
+		void		drawPart(uint16_t x, uint16_t y, uint16_t part_x, uint16_t part_y, uint16_t part_width, uint16_t part_height);
 	private:
 		struct p_data	*ds	= 0;
 };
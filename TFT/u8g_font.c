@@ -8,6 +8,32 @@
 #include "u8g_font.h"
 #include "common.h"
 
+/*
+ * The glyph cache.
+ * The run-length encoded glyph is decoded once into the 1 bpp bitmap (MSB first) of the least recently used cache entry.
+ * The bitmap is kept unscaled, so the entry is keyed by (font, encoding) and serves any font scale: the scale is applied
+ * when the cached bitmap is drawn. The glyphs bigger than U8G2_GLYPH_DATA_SIZE bytes are decoded from the font data every time.
+ */
+#ifdef TFT_GLYPH_CACHE
+#define U8G2_GLYPH_DATA_SIZE	(128)				// Up to 32x32 pixels glyph
+typedef struct s_u8g2_glyph {
+	const uint8_t	*font;							// 0 if the entry is empty
+	uint16_t		encoding;
+	int8_t			width;
+	int8_t			height;
+	int8_t			x;								// Glyph x offset
+	int8_t			y;								// Glyph y offset
+	int8_t			dx;								// Glyph advance
+	uint32_t		used;							// The last usage counter, to replace least recently used entry
+	uint8_t			data[U8G2_GLYPH_DATA_SIZE];
+} u8g2_glyph_t;
+
+static u8g2_glyph_t	glyph_cache[TFT_GLYPH_CACHE];
+static uint32_t		glyph_use_cnt	= 0;
+static uint32_t		glyph_hits		= 0;
+static uint32_t		glyph_misses	= 0;
+#endif
+
 /* size of the font data structure, there is no struct or class... */
 /* this is the size for the new font format */
 #define U8G2_FONT_DATA_STRUCT_SIZE 23
@@ -75,9 +101,16 @@ static u8g2_uint_t 		u8g2_font_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint
 static int8_t 			u8g2_font_decode_glyph(u8g2_t *u8g2, const uint8_t *glyph_data);
 static u8g2_uint_t		u8g2_draw_string(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, const char *str);
 static void 			u8g2_font_decode_len(u8g2_t *u8g2, uint8_t len, uint8_t is_foreground);
+static void				u8g2_font_draw_run(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint8_t len, uint8_t is_foreground);
 static void				u8g2_font_draw_HLine_bitmap(uint8_t* buff, uint16_t width, uint16_t x, uint16_t y, uint8_t length);
 static uint8_t			u8g2_is_all_valid(u8g2_t *u8g2, const char *str);
 static u8g2_uint_t		u8g2_string_width(u8g2_t *u8g2, const char *str);
+#ifdef TFT_GLYPH_CACHE
+static u8g2_glyph_t	   *u8g2_glyph_cache_get(u8g2_t *u8g2, uint16_t encoding);
+static void				u8g2_glyph_cache_fill(u8g2_t *u8g2, u8g2_glyph_t *g, const uint8_t *glyph_data);
+static void				u8g2_glyph_cache_run(u8g2_glyph_t *g, uint8_t *lx, uint8_t *ly, uint8_t len, uint8_t is_foreground);
+static u8g2_uint_t		u8g2_glyph_cache_draw(u8g2_t *u8g2, const u8g2_glyph_t *g);
+#endif
 
 static uint16_t	 		u8x8_ascii_next(u8x8_t *u8x8, uint8_t b);
 static uint16_t 		u8x8_utf8_next(u8x8_t *u8x8, uint8_t b);
@@ -406,6 +439,11 @@ static u8g2_uint_t u8g2_font_draw_glyph(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t
 	u8g2_uint_t dx = 0;
 	u8g2->font_decode.target_x = x;
 	u8g2->font_decode.target_y = y;
+#ifdef TFT_GLYPH_CACHE
+	u8g2_glyph_t *g = u8g2_glyph_cache_get(u8g2, encoding);
+	if (g != 0)
+		return u8g2_glyph_cache_draw(u8g2, g);
+#endif
 	const uint8_t *glyph_data = u8g2_font_get_glyph_data(u8g2, encoding);
 	if (glyph_data != 0) {
 		dx = u8g2_font_decode_glyph(u8g2, glyph_data);
@@ -481,7 +519,6 @@ static void u8g2_font_decode_len(u8g2_t *u8g2, uint8_t len, uint8_t is_foregroun
 	uint8_t lx	= decode->x;				// local coordinates of the glyph
 	uint8_t ly 	= decode->y;
 	uint8_t scale = u8g2->scale;
-	int8_t	max_char_height = u8g2->font_info.max_char_height * scale;
 
 	for (;;) {
 		uint8_t rem = decode->glyph_width;	// remaining pixel to the right edge of the glyph
@@ -499,23 +536,7 @@ static void u8g2_font_decode_len(u8g2_t *u8g2, uint8_t len, uint8_t is_foregroun
 
 		x += lx * scale;
 		y += ly * scale;
-
-		if (decode->buff_width > 0) {		// Decode to the buffer
-			if (is_foreground && y < max_char_height) {
-				for (uint8_t l = 0; l < scale; ++l) {
-					u8g2_font_draw_HLine_bitmap(decode->buff, decode->buff_width, x, y+l, current * scale);
-				}
-			}
-		} else {							// Decode directly to the display
-			// draw foreground and background (if required)
-			for (uint8_t l = 0; l < scale; ++l) {
-				if (is_foreground) {
-					TFT_DrawHLine(x,  y+l,  current * scale, decode->fg_color);
-				} else if (decode->is_transparent == 0) {
-					TFT_DrawHLine(x,  y+l,  current * scale, decode->bg_color);
-				}
-			}
-		}
+		u8g2_font_draw_run(u8g2, x, y, current, is_foreground);
 
 		// check, whether the end of the run length code has been reached
 		if (cnt < rem)
@@ -530,6 +551,33 @@ static void u8g2_font_decode_len(u8g2_t *u8g2, uint8_t len, uint8_t is_foregroun
 	decode->y = ly;
 }
 
+/*
+ *	Draw the glyph line of "len" pixels at (x, y) applying the font scale
+ *	into the string buffer or directly to the display
+ */
+static void u8g2_font_draw_run(u8g2_t *u8g2, u8g2_uint_t x, u8g2_uint_t y, uint8_t len, uint8_t is_foreground) {
+	u8g2_font_decode_t *decode = &(u8g2->font_decode);
+	uint8_t scale = u8g2->scale;
+
+	if (decode->buff_width > 0) {			// Decode to the buffer
+		int8_t	max_char_height = u8g2->font_info.max_char_height * scale;
+		if (is_foreground && y < max_char_height) {
+			for (uint8_t l = 0; l < scale; ++l) {
+				u8g2_font_draw_HLine_bitmap(decode->buff, decode->buff_width, x, y+l, len * scale);
+			}
+		}
+	} else {								// Decode directly to the display
+		// draw foreground and background (if required)
+		for (uint8_t l = 0; l < scale; ++l) {
+			if (is_foreground) {
+				TFT_DrawHLine(x,  y+l,  len * scale, decode->fg_color);
+			} else if (decode->is_transparent == 0) {
+				TFT_DrawHLine(x,  y+l,  len * scale, decode->bg_color);
+			}
+		}
+	}
+}
+
 static void u8g2_font_draw_HLine_bitmap(uint8_t* buff, uint16_t width, uint16_t x, uint16_t y, uint8_t length) {
 //	if (length == 0) return;
 	if (length == 0 || x >= width) return;
@@ -675,3 +723,126 @@ static u8g2_uint_t u8g2_font_calc_vref_center(u8g2_t *u8g2) {
 	tmp += u8g2->font_ref_descent;
 	return tmp;
 }
+
+void u8g2_GlyphCacheStat(uint32_t *hits, uint32_t *misses) {
+#ifdef TFT_GLYPH_CACHE
+	*hits	= glyph_hits;
+	*misses	= glyph_misses;
+#else
+	*hits	= 0;
+	*misses	= 0;
+#endif
+}
+
+void u8g2_GlyphCacheReset(void) {
+#ifdef TFT_GLYPH_CACHE
+	for (uint8_t i = 0; i < TFT_GLYPH_CACHE; ++i)
+		glyph_cache[i].font = 0;
+	glyph_use_cnt	= 0;
+	glyph_hits		= 0;
+	glyph_misses	= 0;
+#endif
+}
+
+#ifdef TFT_GLYPH_CACHE
+/*
+ * Look for the glyph in the cache. If not found, decode the glyph into the least recently used entry.
+ * Returns 0 if the glyph does not exist in the font or it is too big for the cache entry
+ */
+static u8g2_glyph_t *u8g2_glyph_cache_get(u8g2_t *u8g2, uint16_t encoding) {
+	uint8_t lru = 0;
+	for (uint8_t i = 0; i < TFT_GLYPH_CACHE; ++i) {
+		u8g2_glyph_t *g = &glyph_cache[i];
+		if (g->font == u8g2->font && g->encoding == encoding) {
+			++glyph_hits;
+			g->used = ++glyph_use_cnt;
+			return g;
+		}
+		if (g->used < glyph_cache[lru].used)
+			lru = i;
+	}
+	++glyph_misses;
+	const uint8_t *glyph_data = u8g2_font_get_glyph_data(u8g2, encoding);
+	if (glyph_data == 0) return 0;
+	u8g2_font_setup_decode(u8g2, glyph_data);
+	uint16_t size = ((u8g2->font_decode.glyph_width + 7) >> 3) * u8g2->font_decode.glyph_height;
+	if (size > U8G2_GLYPH_DATA_SIZE) return 0;
+
+	u8g2_glyph_t *g = &glyph_cache[lru];
+	u8g2_glyph_cache_fill(u8g2, g, glyph_data);
+	g->font		= u8g2->font;
+	g->encoding	= encoding;
+	g->used		= ++glyph_use_cnt;
+	return g;
+}
+
+// The same decode algorithm as u8g2_font_decode_glyph(), but into the unscaled glyph bitmap
+static void u8g2_glyph_cache_fill(u8g2_t *u8g2, u8g2_glyph_t *g, const uint8_t *glyph_data) {
+	u8g2_font_decode_t *decode = &(u8g2->font_decode);
+
+	u8g2_font_setup_decode(u8g2, glyph_data);
+	g->width	= decode->glyph_width;
+	g->height	= decode->glyph_height;
+	g->x		= u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_x);
+	g->y		= u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_char_y);
+	g->dx		= u8g2_font_decode_get_signed_bits(decode, u8g2->font_info.bits_per_delta_x);
+	memset(g->data, 0, U8G2_GLYPH_DATA_SIZE);
+	if (g->width <= 0) return;
+
+	uint8_t lx = 0;
+	uint8_t ly = 0;
+	for (;;) {
+		uint8_t a = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_0);
+		uint8_t b = u8g2_font_decode_get_unsigned_bits(decode, u8g2->font_info.bits_per_1);
+		do {
+			u8g2_glyph_cache_run(g, &lx, &ly, a, 0);
+			u8g2_glyph_cache_run(g, &lx, &ly, b, 1);
+		} while (u8g2_font_decode_get_unsigned_bits(decode, 1) != 0);
+
+		if (ly >= g->height)
+			break;
+	}
+}
+
+// Put run-length area of the glyph into the glyph bitmap, wrap the line at the glyph border
+static void u8g2_glyph_cache_run(u8g2_glyph_t *g, uint8_t *lx, uint8_t *ly, uint8_t len, uint8_t is_foreground) {
+	uint8_t cnt = len;
+	for (;;) {
+		uint8_t rem = g->width - *lx;
+		uint8_t current = (cnt < rem)?cnt:rem;
+		if (is_foreground && *ly < g->height)
+			u8g2_font_draw_HLine_bitmap(g->data, g->width, *lx, *ly, current);
+		if (cnt < rem)
+			break;
+		cnt -= rem;
+		*lx = 0;
+		++(*ly);
+	}
+	*lx += cnt;
+}
+
+// Draw the cached glyph line by line, each line is split into the foreground and background runs
+static u8g2_uint_t u8g2_glyph_cache_draw(u8g2_t *u8g2, const u8g2_glyph_t *g) {
+	u8g2_font_decode_t *decode = &(u8g2->font_decode);
+	uint8_t scale = u8g2->scale;
+
+	if (g->width > 0) {
+		u8g2_uint_t x0 = decode->target_x + g->x * scale;
+		u8g2_uint_t y0 = decode->target_y - (g->height + g->y) * scale;
+		uint16_t bytes_per_row = (g->width + 7) >> 3;
+		for (uint8_t ly = 0; ly < g->height; ++ly) {
+			const uint8_t *row = &g->data[ly * bytes_per_row];
+			uint8_t lx = 0;
+			while (lx < g->width) {
+				uint8_t fg	= (row[lx >> 3] >> (7 - (lx & 7))) & 1;
+				uint8_t len	= 1;
+				while (lx + len < g->width && ((row[(lx+len) >> 3] >> (7 - ((lx+len) & 7))) & 1) == fg)
+					++len;
+				u8g2_font_draw_run(u8g2, x0 + lx * scale, y0 + ly * scale, len, fg);
+				lx += len;
+			}
+		}
+	}
+	return g->dx * scale;
+}
+#endif
@@ -125,6 +125,9 @@ u8g2_uint_t u8g2_StrToBitmap(u8g2_t *u8g2, uint8_t* buff, uint16_t width, const
 
 uint8_t		u8g2_IsAllValidUTF8(u8g2_t *u8g2, const char *str);		// checks whether all codes are valid
 
+void		u8g2_GlyphCacheStat(uint32_t *hits, uint32_t *misses);	// glyph cache statistics
+void		u8g2_GlyphCacheReset(void);				// drops all cached glyphs and clears statistics
+
 u8g2_uint_t u8g2_GetStrWidth(u8g2_t *u8g2, const char *s);
 u8g2_uint_t u8g2_GetUTF8Width(u8g2_t *u8g2, const char *str);
 
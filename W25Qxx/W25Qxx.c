@@ -12,8 +12,15 @@
  *
  *  2024 Feb 10
  *  	Fixed QSPI support. Write enable now start working
+ *
+ *  2026 Oct 16
+ *  	Added W25Qxx_Program() to program the erased area at any address without erasing the sector
+ *  	Finished the QSPI memory mapped mode. The flash is mapped by W25Qxx_Init(), W25Qxx_Read() copies the mapped data.
+ *  	Any indirect command leaves the memory mapped mode, the write and erase functions map the flash back when finished.
+ *  	Added W25Qxx_MapAddress() to reference the flash data in place
  */
 
+#include <string.h>
 #include "W25Qxx.h"
 
 #define W25Qxx_DUMMY_BYTE         0xA5
@@ -59,6 +66,10 @@ typedef enum {
 } W25Qxx_STATUS;
 
 static uint16_t sector_count = 0;							// Number of the 4k sectors on the device
+#ifdef QSPI
+static bool		mapped			= false;					// The flash is in the memory mapped mode now
+static bool		map_enabled		= false;					// The memory mapped mode should be restored after indirect commands
+#endif
 
 // Static function forward declarations
 static bool			W25Qxx_WriteEnable(void);
@@ -66,13 +77,19 @@ static uint32_t		W25Qxx_JEDEC_ID(void);
 static uint16_t		W25Qxx_Status(bool r1_only);
 static bool			W25Qxx_Command(uint8_t cmd);
 static bool			W25Qxx_EraseSector(uint32_t addr);
-static bool			W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[256]);
+static bool			W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[], uint16_t size);
 static bool			W25Qxx_EraseSector(uint32_t addr);
 static bool			W25Qxx_Wait(uint32_t to);
 static bool			W25Qxx_IsSectorEmpty(uint32_t addr);
+static W25Qxx_RET	W25Qxx_WritePages(uint32_t addr, uint8_t buff[], uint16_t size);
+static W25Qxx_RET	W25Qxx_ProgramData(uint32_t addr, uint8_t buff[], uint16_t size);
+static W25Qxx_RET	W25Qxx_EraseSectors(uint16_t start_sector, uint16_t n_sectors);
+static void			W25Qxx_Remap(void);
 
 #ifdef QSPI
 static bool			W25Qxx_WriteStatusRegister(uint16_t status);
+static bool			W25Qxx_Map(void);
+static void			W25Qxx_Unmap(void);
 #else
 static void			W25Qxx_Select(void);
 static void			W25Qxx_Unselect(void);
@@ -109,16 +126,21 @@ bool W25Qxx_Init(void) {
 			if (!W25Qxx_WriteStatusRegister(stat))
 				return false;
 		}
+		W25Qxx_QSPI_MemoryMapped();
 	}
 	return (sector_count > 0);
 }
 
-// Read data from any address and any size; Usually read by 4k sectors
+// Read data from any address and any size; Usually read by 4k sectors. In the memory mapped mode just copy the data
 W25Qxx_RET W25Qxx_Read(uint32_t addr, uint8_t buff[], uint16_t size) {
 	if (sector_count < (addr >> 12))						// addr / 4096
 		return W25Qxx_RET_ADDR;
 	if (size == 0)
 		return W25Qxx_RET_SIZE;
+	if (mapped) {
+		memcpy(buff, (const void *)(W25Qxx_MAP_BASE + addr), size);
+		return W25Qxx_RET_OK;
+	}
 	if (!W25Qxx_Wait(1000))									// Wait for device ready
 		return W25Qxx_RES_BUSY;
 
@@ -147,7 +169,23 @@ W25Qxx_RET W25Qxx_Read(uint32_t addr, uint8_t buff[], uint16_t size) {
 	return status;
 }
 
+// Enable the memory mapped mode. The mode is restored automatically after the data written
 bool W25Qxx_QSPI_MemoryMapped(void) {
+	map_enabled = true;
+	return W25Qxx_Map();
+}
+
+const uint8_t* W25Qxx_MapAddress(uint32_t addr) {
+	if (!mapped || sector_count <= (addr >> 12))
+		return 0;
+	return (const uint8_t *)(W25Qxx_MAP_BASE + addr);
+}
+
+static bool W25Qxx_Map(void) {
+	if (mapped)
+		return true;
+	if (sector_count == 0 || !W25Qxx_Wait(5000))			// The device should be ready, the mapped data is read directly
+		return false;
 	QSPI_CommandTypeDef		scmd;
 	scmd.InstructionMode	= QSPI_INSTRUCTION_1_LINE;
 	scmd.Instruction 		= CMD_RD_FAST_QUAD_EB;
@@ -167,7 +205,21 @@ bool W25Qxx_QSPI_MemoryMapped(void) {
 	QSPI_MemoryMappedTypeDef	sMemMappedCfg = {0};
     sMemMappedCfg.TimeOutActivation = QSPI_TIMEOUT_COUNTER_DISABLE;
 
-    return (HAL_OK == HAL_QSPI_MemoryMapped(&FLASH_QSPI, &scmd, &sMemMappedCfg));
+    mapped = (HAL_OK == HAL_QSPI_MemoryMapped(&FLASH_QSPI, &scmd, &sMemMappedCfg));
+    return mapped;
+}
+
+// The indirect command cannot be sent in the memory mapped mode, abort the mode
+static void W25Qxx_Unmap(void) {
+	if (mapped) {
+		HAL_QSPI_Abort(&FLASH_QSPI);
+		mapped = false;
+	}
+}
+
+static void W25Qxx_Remap(void) {
+	if (map_enabled)
+		W25Qxx_Map();
 }
 
 #else
@@ -212,10 +264,35 @@ W25Qxx_RET W25Qxx_Read(uint32_t addr, uint8_t buff[], uint16_t size) {
 	W25Qxx_Unselect();
 	return status;
 }
+
+const uint8_t* W25Qxx_MapAddress(uint32_t addr) {
+	return 0;												// The SPI flash cannot be mapped
+}
+
+static void W25Qxx_Remap(void) {
+}
 #endif
 
 // Write data by 256-bytes pages; Usually write whole 4k sector
 W25Qxx_RET W25Qxx_Write(uint32_t addr, uint8_t buff[], uint16_t size) {
+	W25Qxx_RET ret = W25Qxx_WritePages(addr, buff, size);
+	W25Qxx_Remap();
+	return ret;
+}
+
+W25Qxx_RET W25Qxx_Program(uint32_t addr, uint8_t buff[], uint16_t size) {
+	W25Qxx_RET ret = W25Qxx_ProgramData(addr, buff, size);
+	W25Qxx_Remap();
+	return ret;
+}
+
+W25Qxx_RET W25Qxx_Erase(uint16_t start_sector, uint16_t n_sectors) {
+	W25Qxx_RET ret = W25Qxx_EraseSectors(start_sector, n_sectors);
+	W25Qxx_Remap();
+	return ret;
+}
+
+static W25Qxx_RET W25Qxx_WritePages(uint32_t addr, uint8_t buff[], uint16_t size) {
 	if (addr & 0xFF)										// Address should be aligned to the page border, divided by 256, i.e. 0xXXXXXX00
 		return W25Qxx_RET_ALIGN;
 	if (size < 0x100 || (size & 0xFF))
@@ -239,7 +316,7 @@ W25Qxx_RET W25Qxx_Write(uint32_t addr, uint8_t buff[], uint16_t size) {
 
 	// Write data by 256-bytes long pages
 	for (uint16_t start = 0; start < size; start += 256) {
-		if (!W25Qxx_ProgramPage(addr, &buff[start]))
+		if (!W25Qxx_ProgramPage(addr, &buff[start], 256))
 			return W25Qxx_RET_WRITE;
 		addr += 256;
 		if (!W25Qxx_Wait(1000))								// Wait for device ready
@@ -248,7 +325,31 @@ W25Qxx_RET W25Qxx_Write(uint32_t addr, uint8_t buff[], uint16_t size) {
 	return W25Qxx_RET_OK;
 }
 
-W25Qxx_RET W25Qxx_Erase(uint16_t start_sector, uint16_t n_sectors) {
+/*
+ * Program the data into the erased area without erasing the sector. The data can start at any address and have any size,
+ * it is split by the page boundaries. Allows to append small records to the sector (see journal.h)
+ */
+static W25Qxx_RET W25Qxx_ProgramData(uint32_t addr, uint8_t buff[], uint16_t size) {
+	if (size == 0)
+		return W25Qxx_RET_SIZE;
+	if (sector_count <= ((addr + size - 1) >> 12))			// addr / 4096
+		return W25Qxx_RET_ADDR;
+	if (!W25Qxx_Wait(1000))									// Wait for device ready
+		return W25Qxx_RES_BUSY;
+
+	while (size > 0) {
+		uint16_t chunk = 0x100 - (addr & 0xFF);				// The rest of the page
+		if (chunk > size) chunk = size;
+		if (!W25Qxx_ProgramPage(addr, buff, chunk))
+			return W25Qxx_RET_WRITE;
+		addr	+= chunk;
+		buff	+= chunk;
+		size	-= chunk;
+	}
+	return W25Qxx_RET_OK;
+}
+
+static W25Qxx_RET W25Qxx_EraseSectors(uint16_t start_sector, uint16_t n_sectors) {
 	if (n_sectors == 0)
 		return W25Qxx_RET_SIZE;
 	if (sector_count < (start_sector + n_sectors))			// 4k sectors
@@ -296,6 +397,7 @@ static bool W25Qxx_IsSectorEmpty(uint32_t addr) {
 
 #ifdef QSPI
 static uint32_t W25Qxx_JEDEC_ID(void) {
+	W25Qxx_Unmap();
 	QSPI_CommandTypeDef		scmd;
 	scmd.InstructionMode	= QSPI_INSTRUCTION_1_LINE;
 	scmd.Instruction 		= CMD_JEDEC_ID_9F;				// Read JDEC ID
@@ -324,6 +426,7 @@ static uint32_t W25Qxx_JEDEC_ID(void) {
 
 // Reads the status register as two bytes word: R2:R1
 static uint16_t W25Qxx_Status(bool r1_only) {
+	W25Qxx_Unmap();
 	uint16_t stat = 0;
 	uint8_t  ans  = 0;
 	QSPI_CommandTypeDef		scmd;
@@ -361,6 +464,7 @@ static uint16_t W25Qxx_Status(bool r1_only) {
 }
 
 static bool W25Qxx_WriteStatusRegister(uint16_t status) {
+	W25Qxx_Unmap();
 	if (!W25Qxx_Wait(1000))										// Wait for device ready
 		return false;
 	QSPI_CommandTypeDef		scmd;
@@ -387,6 +491,7 @@ static bool W25Qxx_WriteStatusRegister(uint16_t status) {
 
 // Send single command to FLASH W25Qxx
 static bool W25Qxx_Command(uint8_t cmd) {
+	W25Qxx_Unmap();
 	QSPI_CommandTypeDef 	scmd;
 	scmd.InstructionMode	= QSPI_INSTRUCTION_1_LINE;
 	scmd.Instruction 		= cmd;
@@ -406,9 +511,8 @@ static bool W25Qxx_Command(uint8_t cmd) {
 	return (HAL_OK == HAL_QSPI_Command(&FLASH_QSPI, &scmd, HAL_QSPI_TIMEOUT_DEFAULT_VALUE));
 }
 
-// Page size is 256 bytes
-static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[256]) {
-	addr &= 0xFFFFFF00;											// Align to the page boundary. Page size is 256 bytes
+// Page size is 256 bytes. The data should not cross the page boundary
+static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[], uint16_t size) {
 	bool res = false;
 
 	if (!W25Qxx_WriteEnable())
@@ -417,7 +521,7 @@ static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[256]) {
 	QSPI_CommandTypeDef		scmd;
 	scmd.InstructionMode	= QSPI_INSTRUCTION_1_LINE;
 	scmd.Instruction 		= CMD_WR_PAGE_QUAD_32;				// Write Page
-	scmd.NbData 			= 256;								// Write data length.
+	scmd.NbData 			= size;								// Write data length.
 	scmd.DataMode 			= QSPI_DATA_4_LINES;				// Data line width
 	scmd.AddressMode 		= QSPI_ADDRESS_1_LINE;
 	scmd.AlternateByteMode 	= QSPI_ALTERNATE_BYTES_NONE;		// No multiplexing byte stage
@@ -439,6 +543,7 @@ static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[256]) {
 }
 
 static bool W25Qxx_EraseSector(uint32_t addr) {
+	W25Qxx_Unmap();
 	if (sector_count < (addr >> 12))							// addr / 4096
 		return false;
 	if (!W25Qxx_WriteEnable())
@@ -471,6 +576,7 @@ static bool W25Qxx_EraseSector(uint32_t addr) {
 
 
 static bool W25Qxx_Wait(uint32_t to) {
+	W25Qxx_Unmap();
 	uint32_t end = HAL_GetTick() + to;
 	uint8_t stat_r1 = 0;
 	QSPI_CommandTypeDef		scmd;
@@ -547,27 +653,25 @@ static bool W25Qxx_Command(uint8_t cmd) {
 	return ret;
 }
 
-// Page size is 256 bytes
-static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[256]) {
-	addr &= 0xFFFFFF00;						// Align to the page boundary. Page size is 256 bytes
+// Page size is 256 bytes. The data should not cross the page boundary
+static bool W25Qxx_ProgramPage(uint32_t addr, uint8_t buff[], uint16_t size) {
 	bool res = false;
 
 	if (!W25Qxx_WriteEnable())
 		return false;
 
-	// Start address of page must be divided by 256, so the last byte of address is 0
-	uint8_t cmd[5] = { CMD_WR_PAGE_02, (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, 0, 0 };
+	uint8_t cmd[5] = { CMD_WR_PAGE_02, (addr >> 16) & 0xFF, (addr >> 8) & 0xFF, addr & 0xFF, 0 };
 	uint8_t cmd_length = 4;
 	if (sector_count >= 0x2000) {			// W25Q256 and more
 		cmd[1] = (addr >> 24) & 0xFF;
 		cmd[2] = (addr >> 16) & 0xFF;
 		cmd[3] = (addr >> 8)  & 0xFF;
-		cmd[4] = 0;							// last byte of address is always zero
+		cmd[4] = addr & 0xFF;
 		cmd_length = 5;
 	}
 	W25Qxx_Select();
 	if (HAL_OK == HAL_SPI_Transmit(&FLASH_SPI_PORT, (uint8_t *)cmd, cmd_length, 100)) {
-		if (HAL_OK == HAL_SPI_Transmit(&FLASH_SPI_PORT, (uint8_t *)buff, 256, 1000)) {
+		if (HAL_OK == HAL_SPI_Transmit(&FLASH_SPI_PORT, (uint8_t *)buff, size, 1000)) {
 			W25Qxx_Unselect();
 			res = W25Qxx_Wait(1000);
 		}
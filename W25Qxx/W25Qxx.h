@@ -42,6 +42,10 @@
  * SPI quad   wire mode + memory mapping, 170 GHz, prescaler = 1, dummy cycles = 6. Read whole 8-MByte flash takes 1.4 s
  *
  * 2024 Feb 10. Failed to enable write mode, do not know why.
+ *
+ * 2026 Oct 16
+ * 		Added W25Qxx_Program(). The last W25Qxx_RESERVED sectors are not used by FatFS (see diskio.c), they keep the record journal
+ * 		Finished the QSPI memory mapped mode, added W25Qxx_MapAddress() to reference the flash data in place (fonts)
  */
 
 #ifndef W25QXX_H_
@@ -56,6 +60,7 @@
 
 #define FLASH_QSPI			hqspi
 extern QSPI_HandleTypeDef 	FLASH_QSPI;
+#define W25Qxx_MAP_BASE		(0x90000000U)				// The QUADSPI memory mapped area
 
 #else
 
@@ -65,6 +70,8 @@ extern SPI_HandleTypeDef 	FLASH_SPI_PORT;
 
 #endif
 
+#define W25Qxx_RESERVED		(16)						// The number of 4k sectors at the end of the flash reserved for the record journal (see journal.h)
+
 typedef enum {
 	W25Qxx_RET_OK		= 0,
 	W25Qxx_RET_ALIGN,
@@ -89,7 +96,9 @@ bool		W25Qxx_Init(void);
 uint16_t	W25Qxx_SectorCount(void);
 W25Qxx_RET	W25Qxx_Read(uint32_t addr, uint8_t buff[], uint16_t size);
 W25Qxx_RET	W25Qxx_Write(uint32_t addr, uint8_t buff[], uint16_t size);
+W25Qxx_RET	W25Qxx_Program(uint32_t addr, uint8_t buff[], uint16_t size);
 W25Qxx_RET	W25Qxx_Erase(uint16_t start_sector, uint16_t n_sectors);
+const uint8_t* W25Qxx_MapAddress(uint32_t addr);		// The address of the data in the memory mapped flash or zero if the flash is not mapped
 
 #ifdef QSPI
 bool		W25Qxx_QSPI_MemoryMapped(void);
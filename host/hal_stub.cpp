@@ -0,0 +1,76 @@
+/*
+ * hal_stub.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The host implementation of the HAL stub, see stub/stm32f4xx_hal.h
+ *  The timers are initialized as the firmware configures them (see main.c): TIM5 is 100 Hz, its CH4 compare value is 1980.
+ *  The tick counter is advanced by the simulator with HAL_IncTick(), so HAL_Delay() does not wait.
+ */
+
+#include "main.h"
+#include "gun.h"
+
+GPIO_TypeDef		host_gpio[3]	= {};
+TIM_TypeDef			host_tim[4]		= {};
+uint32_t			SystemCoreClock	= 180000000;
+TIM_HandleTypeDef	FAN_TIM			= { TIM11 };
+
+static uint32_t		tick			= 0;
+
+// Setup the TIM5 as main.c does: 90 MHz / (899+1) / (1999+1) = 100 Hz
+static struct s_host_init {
+	s_host_init(void) {
+		TIM5->PSC	= 899;
+		TIM5->ARR	= 1999;
+		TIM5->CCR4	= 1980;
+		TIM11->ARR	= 1999;
+	}
+} host_init;
+
+void HAL_IncTick(void) {
+	++tick;
+}
+
+uint32_t HAL_GetTick(void) {
+	return tick;
+}
+
+void HAL_Delay(uint32_t ms) {
+	tick += ms;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state) {
+	if (state == GPIO_PIN_SET)
+		port->ODR |= pin;
+	else
+		port->ODR &= ~pin;
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin) {
+	return (port->ODR & pin)?GPIO_PIN_SET:GPIO_PIN_RESET;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t channel) {
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Encoder_Stop(TIM_HandleTypeDef *htim, uint32_t channel) {
+	return HAL_OK;
+}
+
+uint32_t HAL_RCC_GetPCLK1Freq(void) {
+	return SystemCoreClock >> 2;
+}
+
+uint32_t HAL_RCC_GetPCLK2Freq(void) {
+	return SystemCoreClock >> 1;
+}
@@ -0,0 +1,41 @@
+/*
+ * plant.cpp
+ *
+ *  Created on: 16 Oct 2026
+ */
+
+#include <math.h>
+#include "plant.h"
+
+void PLANT::init(const tPlantParam &p, uint16_t step_ms) {
+	par		= p;
+	if (par.tau == 0) par.tau = 1;
+	k_step	= 1.0 - exp(-(double)step_ms / (double)par.tau);
+	delay	= par.dead / step_ms;
+	if (delay >= max_delay) delay = max_delay - 1;
+	t_curr	= 0;
+	head	= 0;
+	seed	= 1;
+	for (uint16_t i = 0; i < max_delay; ++i)
+		hist[i] = 0;
+}
+
+void PLANT::step(double u) {
+	if (u < 0) u = 0;
+	if (u > 1) u = 1;
+	t_curr += ((double)par.gain * u - t_curr) * k_step;
+	hist[head] = t_curr;
+	if (++head >= max_delay) head = 0;
+}
+
+uint16_t PLANT::read(void) {
+	uint16_t i = (head + max_delay - 1 - delay) % max_delay;
+	int32_t t = (int32_t)lround(hist[i]);
+	if (par.noise) {
+		seed = seed * 1103515245 + 12345;
+		t += (int32_t)((seed >> 16) % (2 * par.noise + 1)) - par.noise;
+	}
+	if (t < 0)		t = 0;
+	if (t > 4095)	t = 4095;								// The 12-bit ADC
+	return t;
+}
@@ -0,0 +1,43 @@
+/*
+ * plant.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The first-order-plus-dead-time heater model used by the host simulator (see sim.cpp)
+ *  T is the heater temperature above ambient in internal units, u is the applied power share [0; 1]:
+ *    tau * dT/dt = gain * u - T
+ *  The controller reads the temperature delayed by the dead time plus the ADC noise. The noise is generated by the
+ *  linear congruential generator with fixed seed, so every run of the simulator gives the same result.
+ */
+
+#ifndef PLANT_H_
+#define PLANT_H_
+
+#include <stdint.h>
+
+typedef struct s_plant_param {
+	uint32_t	gain;										// The steady-state temperature at full power (internal units)
+	uint32_t	tau;										// The time constant, ms
+	uint32_t	dead;										// The dead time, ms
+	uint16_t	noise;										// The ADC noise amplitude (internal units)
+} tPlantParam;
+
+class PLANT {
+	public:
+		PLANT(void)											{ }
+		void		init(const tPlantParam &p, uint16_t step_ms);
+		void		step(double u);							// Apply the power share u during the step time
+		uint16_t	read(void);								// The delayed temperature with noise, as read by the ADC
+		double		temp(void)								{ return t_curr;								}
+	private:
+		static const uint16_t	max_delay	= 512;			// The dead time buffer size, steps
+		tPlantParam	par				= {0, 1, 0, 0};
+		double		k_step			= 0;					// The exponential step coefficient: 1 - exp(-step/tau)
+		double		t_curr			= 0;					// The actual heater temperature
+		double		hist[max_delay]	= {0};					// The temperature history to implement the dead time
+		uint16_t	delay			= 0;					// The dead time, steps
+		uint16_t	head			= 0;					// The history buffer head index
+		uint32_t	seed			= 1;					// The noise generator state
+};
+
+#endif
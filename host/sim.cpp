@@ -0,0 +1,247 @@
+/*
+ * sim.cpp
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The closed-loop thermal simulator: the firmware IRON, HOTGUN and PID code drives the heater model (see plant.h)
+ *  The simulator repeats the power path of core.cpp with 10 ms step (one TIM5 period or one AC half-period):
+ *  - The IRON is checked every second TIM5 phase, the power greater than one phase is applied in the next phase;
+ *  - The Hot Air Gun temperature is updated every 20 ms, the power is calculated every 1.2 seconds and applied
+ *    by the power pattern (see gun_pattern.h) or by the sigma-delta modulator.
+ *  The heat-up settle time, the overshoot and the steady-state ripple are reported for every case.
+ *
+ *  Usage: sim [case] [key=value ...]
+ *  The case is t12, jbc, gun or gun_sd, all cases are simulated if omitted.
+ *  The keys are: gain, tau, dead, noise (the heater model, see tPlantParam), set (preset temperature), time (seconds),
+ *  band (the settle band, internal units), kp, ki, kd (PID coefficients, see config.cpp)
+ *  The exit status is not zero if the temperature has not been settled in any case.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "iron.h"
+#include "gun.h"
+#include "gun_pattern.h"
+#include "plant.h"
+
+typedef struct s_sim_case {
+	const char	*name;
+	tDevice		dev;
+	bool		sigma_delta;								// The Hot Air Gun power modulator
+	tPlantParam	plant;
+	uint16_t	t_set;										// The preset temperature, internal units
+	uint32_t	time;										// The simulation time, s
+	uint16_t	band;										// The settle band, internal units
+	PIDparam	pid;
+} tSimCase;
+
+typedef struct s_sim_result {
+	int32_t		settle;										// The settle time, ms, or -1 if the temperature has not been settled
+	int32_t		overshoot;									// The maximum temperature above the preset one
+	int32_t		ripple;										// The peak-to-peak temperature in the last quarter of the simulation time
+	uint8_t		power;										// The average power in the last quarter of the simulation time, %
+} tSimResult;
+
+static const uint16_t			step_ms		= 10;			// The TIM5 period and AC half-period
+static const uint16_t			gun_fan		= 600;			// The Hot Air Gun fan speed
+static constexpr GUN_PATTERN	gun_pattern;
+static_assert(gun_pattern.verify(), "Wrong Hot Air Gun power pattern");
+
+// The default heater models and the PID coefficients from config.cpp
+static tSimCase sim_case[] = {
+	{ "t12",	d_t12,	false,	{ 12000, 30000,   60, 3 },	1500,	120, 15,	PIDparam(2300, 50, 735)	},
+	{ "jbc",	d_jbc,	false,	{ 14000, 20000,   40, 3 },	1500,	120, 15,	PIDparam(1479, 59, 507)	},
+	{ "gun",	d_gun,	false,	{ 4000,  15000, 1000, 4 },	1800,	900, 30,	PIDparam(100,  32, 195)	},
+	{ "gun_sd",	d_gun,	true,	{ 4000,  15000, 1000, 4 },	1800,	900, 30,	PIDparam(100,  32, 195)	}
+};
+
+class METER {
+	public:
+		METER(const tSimCase &c) : t_set(c.t_set), band(c.band), end(c.time * 1000), tail(end - end / 4) { }
+		void		update(uint32_t ms, double t, double u);
+		tSimResult	result(void);
+	private:
+		int32_t		t_set;
+		int32_t		band;
+		uint32_t	end;									// The simulation end time, ms
+		uint32_t	tail;									// The steady-state interval start time, ms
+		uint32_t	out_of_band	= 0;						// The last time the temperature was out of settle band, ms
+		double		t_max		= 0;
+		double		tail_min	= 1e9;
+		double		tail_max	= 0;
+		double		tail_power	= 0;
+		uint32_t	tail_cnt	= 0;
+};
+
+void METER::update(uint32_t ms, double t, double u) {
+	if (t > t_max) t_max = t;
+	if (t < t_set - band || t > t_set + band) out_of_band = ms;
+	if (ms >= tail) {
+		if (t < tail_min) tail_min = t;
+		if (t > tail_max) tail_max = t;
+		tail_power += u;
+		++tail_cnt;
+	}
+}
+
+tSimResult METER::result(void) {
+	tSimResult r;
+	r.settle	= (out_of_band + step_ms < tail)?(int32_t)(out_of_band + step_ms):-1;
+	r.overshoot	= (t_max > t_set)?(int32_t)(t_max - t_set + 0.5):0;
+	r.ripple	= (int32_t)(tail_max - tail_min + 0.5);
+	r.power		= tail_cnt?(uint8_t)(tail_power * 100 / tail_cnt + 0.5):0;
+	return r;
+}
+
+static void ticks(uint16_t ms) {
+	for (uint16_t i = 0; i < ms; ++i)
+		HAL_IncTick();
+}
+
+// See the TIM5 CH4 compare handler in core.cpp: the IRON is checked in its phase, the rest of power is applied in the next phase
+static tSimResult runIron(const tSimCase &c) {
+	IRON	iron;
+	PLANT	plant;
+	METER	meter(c);
+	iron.init(c.dev);
+	iron.load(c.pid);
+	iron.setTemp(c.t_set);
+	iron.switchPower(true);
+	plant.init(c.plant, step_ms);
+
+	const uint16_t	max_iron_pwm	= TIM5->CCR4 - 40;
+	const double	period			= TIM5->ARR + 1;
+	uint16_t		rest			= 0;					// The power to be applied in the next phase
+	for (uint32_t ms = 0; ms < c.time * 1000; ms += step_ms) {
+		uint16_t pwm = rest;
+		if ((ms / step_ms) & 1) {
+			rest = 0;
+		} else {
+			uint16_t p = iron.power(plant.read());
+			pwm	 = (p > max_iron_pwm)?max_iron_pwm:p;
+			rest = p - pwm;
+		}
+		TIM5->CCR1 = pwm;
+		double u = (double)TIM5->CCR1 / period;
+		plant.step(u);
+		ticks(step_ms);
+		meter.update(ms, plant.temp(), u);
+	}
+	return meter.result();
+}
+
+// See updateGunPower(), fillGunPowerData() and fillGunPowerSD() in core.cpp
+static tSimResult runGun(const tSimCase &c) {
+	HOTGUN		gun;
+	PLANT		plant;
+	METER		meter(c);
+	bool		active[GUN_SLOTS]	= {false};				// The AC half-periods to be powered
+	uint16_t	sd_acc				= 0;
+	gun.init();
+	gun.load(c.pid);
+	gun.setSigmaDelta(c.sigma_delta);
+	gun.setFan(gun_fan);
+	gun.setTemp(c.t_set);
+	for (uint8_t i = 0; i < 50; ++i)
+		gun.updateCurrent(1500);							// The fan current: the Hot Air Gun is connected
+	gun.switchPower(true);
+	plant.init(c.plant, step_ms);
+
+	uint8_t slot = 0;
+	for (uint32_t ms = 0; ms < c.time * 1000; ms += step_ms) {
+		if (slot == 0) {
+			gun.power();
+			uint16_t pwr = gun.finePower();
+			if (c.sigma_delta) {
+				const uint16_t full = GUN_SLOTS << GUN_POWER_Q;
+				for (uint8_t i = 0; i < GUN_SLOTS; ++i) {
+					sd_acc += pwr;
+					active[i] = sd_acc >= full;
+					if (active[i]) sd_acc -= full;
+				}
+			} else {
+				for (uint8_t i = 0; i < GUN_SLOTS; ++i)
+					active[i] = gun_pattern.isActive(pwr >> GUN_POWER_Q, i);
+			}
+		}
+		if ((ms / step_ms) & 1) {
+			gun.updateCurrent(1500);
+			gun.updateTemp(plant.read());
+		}
+		double u = active[slot]?1.0:0.0;
+		plant.step(u);
+		ticks(step_ms);
+		meter.update(ms, plant.temp(), u);
+		if (++slot >= GUN_SLOTS) slot = 0;
+	}
+	return meter.result();
+}
+
+static bool isKey(const char *arg, size_t len, const char *key) {
+	return len == strlen(key) && !strncmp(arg, key, len);
+}
+
+static bool parseArg(tSimCase &c, const char *arg) {
+	const char *eq = strchr(arg, '=');
+	if (!eq) return false;
+	size_t	len	= eq - arg;
+	long	v	= atol(eq + 1);
+	if		(isKey(arg, len, "gain"))	c.plant.gain	= v;
+	else if (isKey(arg, len, "tau"))	c.plant.tau		= v;
+	else if (isKey(arg, len, "dead"))	c.plant.dead	= v;
+	else if (isKey(arg, len, "noise"))	c.plant.noise	= v;
+	else if (isKey(arg, len, "set"))	c.t_set			= v;
+	else if (isKey(arg, len, "time"))	c.time			= v;
+	else if (isKey(arg, len, "band"))	c.band			= v;
+	else if (isKey(arg, len, "kp"))	c.pid.Kp		= v;
+	else if (isKey(arg, len, "ki"))	c.pid.Ki		= v;
+	else if (isKey(arg, len, "kd"))	c.pid.Kd		= v;
+	else return false;
+	return true;
+}
+
+int main(int argc, char *argv[]) {
+	const uint8_t cases = sizeof(sim_case) / sizeof(tSimCase);
+	int		first	= 0;
+	int		last	= cases - 1;
+	int		a		= 1;
+	if (argc > 1 && !strchr(argv[1], '=')) {
+		for (first = 0; first < cases; ++first)
+			if (!strcmp(argv[1], sim_case[first].name)) break;
+		if (first >= cases) {
+			fprintf(stderr, "Unknown case: %s\n", argv[1]);
+			return 2;
+		}
+		last = first;
+		++a;
+	}
+	for (; a < argc; ++a) {
+		for (int i = first; i <= last; ++i) {
+			if (!parseArg(sim_case[i], argv[a])) {
+				fprintf(stderr, "Wrong parameter: %s\n", argv[a]);
+				return 2;
+			}
+		}
+	}
+
+	int		status	= 0;
+	double	sim_s	= 0;
+	clock_t	start	= clock();
+	printf("%-8s %6s %10s %10s %8s %7s\n", "case", "set", "settle, s", "overshoot", "ripple", "power");
+	for (int i = first; i <= last; ++i) {
+		const tSimCase &c = sim_case[i];
+		tSimResult r = (c.dev == d_gun)?runGun(c):runIron(c);
+		sim_s += c.time;
+		if (r.settle < 0) {
+			printf("%-8s %6d %10s %10d %8d %6d%%\n", c.name, c.t_set, "-", r.overshoot, r.ripple, r.power);
+			status = 1;
+		} else {
+			printf("%-8s %6d %10.2f %10d %8d %6d%%\n", c.name, c.t_set, r.settle / 1000.0, r.overshoot, r.ripple, r.power);
+		}
+	}
+	double wall = (double)(clock() - start) / CLOCKS_PER_SEC;
+	printf("Simulated %.0f s in %.3f s\n", sim_s, wall);
+	return status;
+}
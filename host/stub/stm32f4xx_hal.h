@@ -0,0 +1,102 @@
+/*
+ * stm32f4xx_hal.h
+ *
+ *  Created on: 16 Oct 2026
+ *
+ *  The host stub of the STM32 HAL: the types, registers and functions used by the control path units only.
+ *  The timers are plain structures in RAM, the tick counter is driven by the simulator (see hal_stub.cpp).
+ */
+
+#ifndef STM32F4XX_HAL_STUB_H_
+#define STM32F4XX_HAL_STUB_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum { HAL_OK = 0, HAL_ERROR, HAL_BUSY, HAL_TIMEOUT } HAL_StatusTypeDef;
+typedef enum { GPIO_PIN_RESET = 0, GPIO_PIN_SET } GPIO_PinState;
+
+typedef struct {
+	volatile uint32_t	MODER;
+	volatile uint32_t	ODR;
+} GPIO_TypeDef;
+
+typedef struct {
+	volatile uint32_t	CR1;
+	volatile uint32_t	CNT;
+	volatile uint32_t	PSC;
+	volatile uint32_t	ARR;
+	volatile uint32_t	CCR1;
+	volatile uint32_t	CCR2;
+	volatile uint32_t	CCR3;
+	volatile uint32_t	CCR4;
+} TIM_TypeDef;
+
+typedef struct {
+	TIM_TypeDef			*Instance;
+} TIM_HandleTypeDef;
+
+typedef struct {
+	void				*Instance;
+} SPI_HandleTypeDef;
+
+extern GPIO_TypeDef		host_gpio[3];
+extern TIM_TypeDef		host_tim[4];
+extern uint32_t			SystemCoreClock;
+
+#define GPIOA			(&host_gpio[0])
+#define GPIOB			(&host_gpio[1])
+#define GPIOC			(&host_gpio[2])
+#define TIM1			(&host_tim[0])
+#define TIM5			(&host_tim[1])
+#define TIM11			(&host_tim[2])
+#define TIM12			(&host_tim[3])
+
+#define GPIO_PIN_0		((uint16_t)0x0001)
+#define GPIO_PIN_1		((uint16_t)0x0002)
+#define GPIO_PIN_2		((uint16_t)0x0004)
+#define GPIO_PIN_3		((uint16_t)0x0008)
+#define GPIO_PIN_4		((uint16_t)0x0010)
+#define GPIO_PIN_5		((uint16_t)0x0020)
+#define GPIO_PIN_6		((uint16_t)0x0040)
+#define GPIO_PIN_7		((uint16_t)0x0080)
+#define GPIO_PIN_8		((uint16_t)0x0100)
+#define GPIO_PIN_9		((uint16_t)0x0200)
+#define GPIO_PIN_10		((uint16_t)0x0400)
+#define GPIO_PIN_11		((uint16_t)0x0800)
+#define GPIO_PIN_12		((uint16_t)0x1000)
+#define GPIO_PIN_13		((uint16_t)0x2000)
+#define GPIO_PIN_14		((uint16_t)0x4000)
+#define GPIO_PIN_15		((uint16_t)0x8000)
+
+#define TIM_CHANNEL_1	(0x00000000U)
+#define TIM_CHANNEL_2	(0x00000004U)
+#define TIM_CHANNEL_3	(0x00000008U)
+#define TIM_CHANNEL_4	(0x0000000CU)
+#define TIM_CHANNEL_ALL	(0x0000003CU)
+
+#define __DMB()			__sync_synchronize()
+#define __WFI()			do { } while (0)
+
+void		HAL_IncTick(void);
+uint32_t	HAL_GetTick(void);
+void		HAL_Delay(uint32_t ms);
+void		HAL_GPIO_WritePin(GPIO_TypeDef *port, uint16_t pin, GPIO_PinState state);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint16_t pin);
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_PWM_Stop(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_Encoder_Start(TIM_HandleTypeDef *htim, uint32_t channel);
+HAL_StatusTypeDef HAL_TIM_Encoder_Stop(TIM_HandleTypeDef *htim, uint32_t channel);
+uint32_t	HAL_RCC_GetPCLK1Freq(void);
+uint32_t	HAL_RCC_GetPCLK2Freq(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif